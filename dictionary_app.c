@@ -1,6 +1,8 @@
 #include "dictionary_app.h"
 #include "dictionary_i.h"
 #include "dictionary_data.h"
+#include "dictionary_favorites.h"
+#include "dictionary_journal.h"
 #include "dictionary_ui.h"
 
 #include "furi.h"
@@ -13,17 +15,30 @@
 #include <string.h>
 #include <stdio.h>
 
+#define TAG "DictionaryApp"
+
+#define DICTIONARY_APP_JOURNAL_PATH APP_DATA_PATH("user.journal")
+
+// Where the profile view saves the counters and timings
+#define DICTIONARY_APP_PROFILE_PATH APP_DATA_PATH("profile.txt")
+
+static void dictionary_app_journal_replay(DictionaryJournalRecordType type, const char* word, void* context);
+static void dictionary_app_search_callback(const DictionarySearchResults* results, void* context);
+
 // Initialize the dictionary application
 static bool dictionary_app_init(DictionaryApp* app) {
     // Initialize the event queue
-    app->event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    app->event_queue = furi_message_queue_alloc(DICTIONARY_APP_EVENT_QUEUE_SIZE, sizeof(DictionaryEvent));
+    app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
     // Initialize GUI
     app->gui = furi_record_open(RECORD_GUI);
     app->view_port = view_port_alloc();
     view_port_draw_callback_set(app->view_port, dictionary_ui_draw_callback, app);
     view_port_input_callback_set(app->view_port, dictionary_ui_input_callback, app);
+    app->frame_valid = false;
     gui_add_view_port(app->gui, app->view_port, GuiLayerFullscreen);
+    gui_add_framebuffer_callback(app->gui, dictionary_ui_framebuffer_callback, app);
 
     // Initialize notifications
     app->notifications = furi_record_open(RECORD_NOTIFICATION);
@@ -31,85 +46,507 @@ static bool dictionary_app_init(DictionaryApp* app) {
     // Initialize application state
     app->search_term_length = 0;
     app->search_term[0] = '\0';
+    memset(app->search_prefix, 0, sizeof(app->search_prefix));
+    memset(app->search_letters, 0, sizeof(app->search_letters));
+    app->search_mode = DictionarySearchEnglish;
+    app->search_starts_length = UINT8_MAX;
     app->current_word_index = 0;
     app->scroll_position = 0;
+    app->scroll_repeats = 0;
+    app->prefetch_pending = false;
+    app->prefetch_forward = true;
     app->showing_definition = false;
     app->is_searching = false;
     
     // Initialize favorites
-    app->favorites_count = 0;
     app->showing_favorites = false;
+    app->showing_history = false;
     app->current_favorite_index = 0;
-    memset(app->favorites, 0, sizeof(app->favorites));
+    app->history_count = 0;
     
     // Initialize search results
     app->showing_search_results = false;
-    app->search_results = NULL;
+    app->search_results_first = 0;
     app->search_results_count = 0;
+    app->search_results_total = 0;
     app->current_search_index = 0;
+    app->search_results_source = DictionaryResultsWords;
+    app->completion_count = 0;
     
     // Initialize translation mode
     app->show_translation = false;
 
+#if DICTIONARY_PROFILE
+    app->showing_profile = false;
+    app->profile_position = 0;
+    app->profile_status = NULL;
+#endif
+
     // Initialize dictionary data
     dictionary_data_init();
+    app->favorites = dictionary_favorites_alloc(dictionary_data_get_word_count());
+    app->layout = dictionary_layout_alloc();
+
+    // The main list leaves room for its scrollbar, the search results for
+    // the term above them
+    DictionaryListStyle word_style = {
+        .top = 15, .rows = DICTIONARY_APP_PAGE_WORDS, .lead = 2, .width = 124, .scrollbar = true};
+    DictionaryListStyle result_style = {.top = 25, .rows = 3, .lead = 1, .width = 128, .scrollbar = false};
+    DictionaryListStyle favorite_style = {.top = 15, .rows = 5, .lead = 2, .width = 128, .scrollbar = false};
+    app->word_list = dictionary_list_alloc(&word_style);
+    app->result_list = dictionary_list_alloc(&result_style);
+    app->favorite_list = dictionary_list_alloc(&favorite_style);
+
+    // Restore favorites and history
+    app->unresolved_favorites = (DictionaryAppWords){.words = NULL, .size = 0, .count = 0};
+    app->unresolved_history = (DictionaryAppWords){.words = NULL, .size = 0, .count = 0};
+    app->storage = furi_record_open(RECORD_STORAGE);
+    app->journal = dictionary_journal_open(
+        app->storage, DICTIONARY_APP_JOURNAL_PATH, dictionary_app_journal_replay, app);
+
+    // Long queries run on the search worker
+    app->search_query = 0;
+    app->search_done = true;
+    app->search_event_pending = false;
+    app->search = dictionary_search_alloc(app->mutex, dictionary_app_search_callback, app);
+
+    return true;
+}
+
+// Russian letters offered by the letter picker, а to я (U+0430 to U+044F)
+#define DICTIONARY_APP_RUSSIAN_FIRST 0x430
+#define DICTIONARY_APP_RUSSIAN_LETTERS 32
+
+// Full-text search offers a space after z to separate words
+#define DICTIONARY_APP_TEXT_LETTERS 27
+
+// Get the number of bytes of one letter in the current search mode
+static uint8_t dictionary_app_get_letter_size(DictionaryApp* app) {
+    return app->search_mode == DictionarySearchRussian ? 2 : 1;
+}
+
+// Get the number of letters the letter picker cycles through
+static uint8_t dictionary_app_get_alphabet_size(DictionaryApp* app) {
+    switch(app->search_mode) {
+    case DictionarySearchRussian:
+        return DICTIONARY_APP_RUSSIAN_LETTERS;
+    case DictionarySearchText:
+        return DICTIONARY_APP_TEXT_LETTERS;
+    default:
+        return 26;
+    }
+}
+
+// Start the matches of the empty search term for the current search mode
+static void dictionary_app_start_search(DictionaryApp* app) {
+    app->search_starts_length = UINT8_MAX;
+    if(app->search_mode == DictionarySearchRussian) {
+        dictionary_data_translation_start(&app->search_prefix[0]);
+    } else {
+        dictionary_data_prefix_start(&app->search_prefix[0]);
+    }
+}
+
+// Get the letters of the alphabet that continue the search term, as a
+// bitmask. Full-text search takes any letter, a term can name any word.
+static uint32_t dictionary_app_get_next_letters(DictionaryApp* app) {
+    const DictionaryPrefix* prefix = &app->search_prefix[app->search_term_length];
+    switch(app->search_mode) {
+    case DictionarySearchRussian:
+        app->search_starts_length = app->search_term_length;
+        return dictionary_data_translation_get_next_letters(prefix, app->search_term, app->search_starts);
+    case DictionarySearchText:
+        return (1u << DICTIONARY_APP_TEXT_LETTERS) - 1;
+    default:
+        return dictionary_data_prefix_get_next_letters(prefix);
+    }
+}
+
+// Step from a letter to the next one (or the previous one) the picker offers
+static uint8_t dictionary_app_step_letter(uint32_t letters, uint8_t letter, uint8_t alphabet_size, bool forward) {
+    for(uint8_t i = 0; i < alphabet_size; i++) {
+        letter = forward ? (letter + 1) % alphabet_size : (letter + alphabet_size - 1) % alphabet_size;
+        if(letters & (1u << letter)) break;
+    }
+    return letter;
+}
+
+// Get the position in the alphabet of the last letter of the search term
+static uint8_t dictionary_app_get_last_letter(DictionaryApp* app) {
+    const uint8_t* end = (const uint8_t*)app->search_term + app->search_term_length;
+    if(app->search_mode == DictionarySearchRussian) {
+        uint16_t code = ((end[-2] & 0x1f) << 6) | (end[-1] & 0x3f);
+        return code - DICTIONARY_APP_RUSSIAN_FIRST;
+    }
+    return end[-1] == ' ' ? 26 : end[-1] - 'a';
+}
 
+// Take the most frequent words of the prefix range to list first
+static void dictionary_app_set_completions(DictionaryApp* app, const DictionarySearchResults* results) {
+    app->completion_count = results->count;
+    for(uint8_t i = 0; i < app->completion_count; i++) {
+        app->completions[i].index = results->indices[i];
+        app->completions[i].rank = results->scores[i];
+    }
+
+    // Insertion sort into word order for mapping list positions
+    for(uint8_t i = 0; i < app->completion_count; i++) {
+        uint32_t index = app->completions[i].index;
+        uint8_t position = i;
+        while(position > 0 && app->completion_indices[position - 1] > index) {
+            app->completion_indices[position] = app->completion_indices[position - 1];
+            position--;
+        }
+        app->completion_indices[position] = index;
+    }
+}
+
+// Take new results of the search worker, called on its thread with the
+// mutex held
+static void dictionary_app_search_callback(const DictionarySearchResults* results, void* context) {
+    DictionaryApp* app = context;
+    if(results->id != app->search_query) return; // Replaced since
+
+    if(results->type == DictionarySearchQueryCompletions) {
+        dictionary_app_set_completions(app, results);
+    } else if(results->type == DictionarySearchQuerySuggestions) {
+        app->search_results_count = results->count;
+        for(uint32_t i = 0; i < results->count; i++) {
+            app->suggestions[i].index = results->indices[i];
+            app->suggestions[i].distance = results->scores[i];
+        }
+    } else {
+        // Only the first matches are kept, but all of them are counted
+        memcpy(app->definition_results, results->indices, results->count * sizeof(uint32_t));
+        app->search_results_count = results->count;
+        app->search_results_total = results->total;
+    }
+    app->search_done = results->done;
+
+    // One queued event redraws for however many results come in before it
+    if(!app->search_event_pending) {
+        DictionaryEvent event = {.type = DictionaryEventSearch};
+        app->search_event_pending = furi_message_queue_put(app->event_queue, &event, 0) == FuriStatusOk;
+    }
+}
+
+// Hand a query for the search term to the worker, its results replace the
+// ones shown as they come in
+static void dictionary_app_submit_search(DictionaryApp* app, DictionarySearchQueryType type) {
+    DictionarySearchQuery query = {.type = type};
+    snprintf(query.term, sizeof(query.term), "%s", app->search_term);
+    query.prefix = app->search_prefix[app->search_term_length];
+
+    if(type == DictionarySearchQueryCompletions) {
+        query.max_results = DICTIONARY_APP_COMPLETIONS_MAX;
+        app->completion_count = 0;
+    } else if(type == DictionarySearchQuerySuggestions) {
+        query.max_results = DICTIONARY_APP_SUGGESTIONS_MAX;
+        app->search_results_count = 0;
+    } else {
+        query.max_results = DICTIONARY_APP_DEFINITION_RESULTS_MAX;
+        app->search_results_count = 0;
+        app->search_results_total = 0;
+    }
+    app->search_query = dictionary_search_submit(app->search, &query);
+    app->search_done = false;
+}
+
+// Stop the query in flight, its results so far stay
+static void dictionary_app_cancel_search(DictionaryApp* app) {
+    if(app->search_query == 0) return;
+    dictionary_search_cancel(app->search);
+    app->search_query = 0;
+    app->search_done = true;
+}
+
+// Replace the last letter of the search term with a letter of the alphabet
+static void dictionary_app_set_last_letter(DictionaryApp* app, uint8_t letter) {
+    uint8_t length = app->search_term_length;
+    if(app->search_mode == DictionarySearchRussian) {
+        // Two-byte UTF-8 sequence
+        uint16_t code = DICTIONARY_APP_RUSSIAN_FIRST + letter;
+        app->search_term[length - 2] = 0xc0 | (code >> 6);
+        app->search_term[length - 1] = 0x80 | (code & 0x3f);
+
+        // Narrow the translations of the term without the letter, to the run
+        // of the letter if the letters offered were just found
+        app->search_prefix[length] = app->search_prefix[length - 2];
+        if(app->search_starts_length == length - 2) {
+            app->search_prefix[length].first = app->search_starts[letter];
+            app->search_prefix[length].last = app->search_starts[letter + 1];
+        } else {
+            dictionary_data_translation_narrow(&app->search_prefix[length], app->search_term);
+        }
+        return;
+    }
+    if(app->search_mode == DictionarySearchText) {
+        // Count the matches in the background while the term is typed
+        app->search_term[length - 1] = letter < 26 ? 'a' + letter : ' ';
+        dictionary_app_submit_search(app, DictionarySearchQueryDefinitions);
+        return;
+    }
+
+    // Narrow the word search to the new letter
+    app->search_term[length - 1] = 'a' + letter;
+    app->search_prefix[length] = app->search_prefix[length - 1];
+    dictionary_data_prefix_add(&app->search_prefix[length], app->search_term[length - 1]);
+}
+
+// Move the last letter of the search term steps letters forward or back
+// among those the picker offers. Returns false if the letter stayed.
+static bool dictionary_app_cycle_letter(DictionaryApp* app, bool forward, uint32_t steps) {
+    uint32_t letters = app->search_letters[app->search_term_length - dictionary_app_get_letter_size(app)];
+    uint8_t alphabet_size = dictionary_app_get_alphabet_size(app);
+    uint8_t old_letter = dictionary_app_get_last_letter(app);
+    uint8_t letter = old_letter;
+    for(uint32_t i = 0; i < steps % alphabet_size; i++) {
+        letter = dictionary_app_step_letter(letters, letter, alphabet_size, forward);
+    }
+    if(letter == old_letter) return false;
+
+    // Only the final letter narrows the search
+    dictionary_app_set_last_letter(app, letter);
     return true;
 }
 
-// Helper function to check if a word is a favorite
-static bool is_word_favorite(DictionaryApp* app, uint32_t word_index) {
-    for(uint8_t i = 0; i < app->favorites_count; i++) {
-        if(app->favorites[i] == word_index) {
-            return true;
+// Remove the last letter of the search term
+static void dictionary_app_remove_letter(DictionaryApp* app) {
+    app->search_term_length -= dictionary_app_get_letter_size(app);
+    app->search_term[app->search_term_length] = '\0';
+    if(app->search_mode == DictionarySearchText) {
+        if(app->search_term_length > 0) {
+            dictionary_app_submit_search(app, DictionarySearchQueryDefinitions);
+        } else {
+            dictionary_app_cancel_search(app);
         }
     }
+}
+
+// Get the word index of a search result
+uint32_t dictionary_app_get_search_result(DictionaryApp* app, uint32_t position) {
+    switch(app->search_results_source) {
+    case DictionaryResultsTranslations:
+        return dictionary_data_get_translation_entry(app->search_results_first + position);
+    case DictionaryResultsSuggestions:
+        return app->suggestions[position].index;
+    case DictionaryResultsDefinitions:
+        return app->definition_results[position];
+    default:
+        break;
+    }
+
+    // The completions come first, then the rest of the range without them
+    if(position < app->completion_count) {
+        return app->completions[position].index;
+    }
+    uint32_t index = app->search_results_first + position - app->completion_count;
+    for(uint8_t i = 0; i < app->completion_count; i++) {
+        if(app->completion_indices[i] <= index) {
+            index++;
+        }
+    }
+    return index;
+}
+
+// Move a word to the front of the history
+static void dictionary_app_push_history(DictionaryApp* app, uint32_t word_index) {
+    uint32_t position = 0;
+    while(position < app->history_count && app->history[position] != word_index) {
+        position++;
+    }
+    if(position == app->history_count && app->history_count < DICTIONARY_APP_HISTORY_MAX) {
+        app->history_count++;
+    }
+    if(position == DICTIONARY_APP_HISTORY_MAX) {
+        position--; // Drop the oldest lookup
+    }
+    memmove(&app->history[1], &app->history[0], position * sizeof(uint32_t));
+    app->history[0] = word_index;
+}
+
+// Find a word in a list, returns its offset or -1
+static int32_t dictionary_app_words_find(const DictionaryAppWords* words, const char* word) {
+    for(size_t offset = 0; offset < words->size; offset += strlen(words->words + offset) + 1) {
+        if(strcmp(words->words + offset, word) == 0) return offset;
+    }
+    return -1;
+}
+
+// Remove the word at an offset of a list
+static void dictionary_app_words_remove(DictionaryAppWords* words, size_t offset) {
+    size_t length = strlen(words->words + offset) + 1;
+    memmove(words->words + offset, words->words + offset + length, words->size - offset - length);
+    words->size -= length;
+    words->count--;
+}
+
+// Add a word to the end of a list
+static void dictionary_app_words_add(DictionaryAppWords* words, const char* word) {
+    size_t length = strlen(word) + 1;
+    words->words = realloc(words->words, words->size + length);
+    memcpy(words->words + words->size, word, length);
+    words->size += length;
+    words->count++;
+}
+
+// Apply a saved record of a word missing from this dictionary
+static void dictionary_app_journal_replay_unresolved(
+    DictionaryApp* app,
+    DictionaryJournalRecordType type,
+    const char* word) {
+    DictionaryAppWords* words =
+        type == DictionaryJournalLookup ? &app->unresolved_history : &app->unresolved_favorites;
+    int32_t offset = dictionary_app_words_find(words, word);
+    if(offset >= 0) {
+        dictionary_app_words_remove(words, offset);
+    }
+    if(type == DictionaryJournalFavoriteRemove) return;
+
+    dictionary_app_words_add(words, word);
+    if(type == DictionaryJournalLookup && words->count > DICTIONARY_APP_HISTORY_MAX) {
+        dictionary_app_words_remove(words, 0); // Drop the oldest lookup
+    }
+}
+
+// Apply a saved record to the favorites or history
+static void dictionary_app_journal_replay(DictionaryJournalRecordType type, const char* word, void* context) {
+    DictionaryApp* app = context;
+    int32_t word_index = dictionary_data_find_word_index(word);
+    if(word_index < 0) {
+        dictionary_app_journal_replay_unresolved(app, type, word);
+        return;
+    }
+
+    if(type == DictionaryJournalFavoriteAdd) {
+        dictionary_favorites_add(app->favorites, word_index);
+    } else if(type == DictionaryJournalFavoriteRemove) {
+        dictionary_favorites_remove(app->favorites, word_index);
+    } else {
+        dictionary_app_push_history(app, word_index);
+    }
+}
+
+// Position in the state written out when compacting the journal
+typedef struct {
+    DictionaryApp* app;
+    uint32_t position;
+    size_t unresolved_offset; // Into the unresolved words of the position
+} DictionaryAppJournalState;
+
+// Get the number of records of the state
+static uint32_t dictionary_app_journal_state_count(DictionaryApp* app) {
+    return dictionary_favorites_get_count(app->favorites) + app->unresolved_favorites.count +
+           app->unresolved_history.count + app->history_count;
+}
+
+// Get the next record of the state: favorites, the unresolved favorites and
+// lookups, then history oldest first
+static bool dictionary_app_journal_state(DictionaryJournalRecordType* type, const char** word, void* context) {
+    DictionaryAppJournalState* state = context;
+    DictionaryApp* app = state->app;
+    uint32_t favorites_count = dictionary_favorites_get_count(app->favorites);
+    uint32_t position = state->position++;
+
+    if(position < favorites_count) {
+        *type = DictionaryJournalFavoriteAdd;
+        *word = dictionary_data_get_word(dictionary_favorites_get(app->favorites, position));
+        return true;
+    }
+    position -= favorites_count;
+    uint32_t unresolved_count = app->unresolved_favorites.count + app->unresolved_history.count;
+    if(position < unresolved_count) {
+        DictionaryAppWords* words = &app->unresolved_favorites;
+        *type = DictionaryJournalFavoriteAdd;
+        if(position >= app->unresolved_favorites.count) {
+            words = &app->unresolved_history;
+            *type = DictionaryJournalLookup;
+        }
+        if(position == 0 || position == app->unresolved_favorites.count) {
+            state->unresolved_offset = 0;
+        }
+        *word = words->words + state->unresolved_offset;
+        state->unresolved_offset += strlen(*word) + 1;
+        return true;
+    }
+    position -= unresolved_count;
+    if(position < app->history_count) {
+        *type = DictionaryJournalLookup;
+        *word = dictionary_data_get_word(app->history[app->history_count - 1 - position]);
+        return true;
+    }
     return false;
 }
 
+// Save a change to favorites or history, compacting the journal now and then
+static void dictionary_app_save(DictionaryApp* app, DictionaryJournalRecordType type, uint32_t word_index) {
+    if(app->journal == NULL) return;
+
+    DictionaryAppJournalState state = {.app = app, .position = 0, .unresolved_offset = 0};
+    bool saved = dictionary_journal_append(app->journal, type, dictionary_data_get_word(word_index)) &&
+                 dictionary_journal_compact(
+                     app->journal, dictionary_app_journal_state_count(app), dictionary_app_journal_state, &state);
+    if(!saved) {
+        // The state already holds the change, so writing all of it saves it
+        state.position = 0;
+        state.unresolved_offset = 0;
+        saved = dictionary_journal_rewrite(app->journal, dictionary_app_journal_state, &state);
+    }
+    if(!saved) {
+        FURI_LOG_E(TAG, "Favorites and history are not saved");
+    }
+}
+
+// Record that a word was looked up
+static void dictionary_app_record_lookup(DictionaryApp* app, uint32_t word_index) {
+    dictionary_app_push_history(app, word_index);
+    dictionary_app_save(app, DictionaryJournalLookup, word_index);
+}
+
+// Get the number of words in the favorites view
+uint32_t dictionary_app_get_list_count(DictionaryApp* app) {
+    return app->showing_history ? app->history_count : dictionary_favorites_get_count(app->favorites);
+}
+
+// Get the word index at a position of the favorites view
+uint32_t dictionary_app_get_list_item(DictionaryApp* app, uint32_t position) {
+    return app->showing_history ? app->history[position] : dictionary_favorites_get(app->favorites, position);
+}
+
 // Helper function to add a word to favorites
 static bool add_to_favorites(DictionaryApp* app, uint32_t word_index) {
-    // Check if word is already a favorite
-    if(is_word_favorite(app, word_index)) {
+    if(!dictionary_favorites_add(app->favorites, word_index)) {
         return false; // Already a favorite
     }
-    
-    // Check if favorites list is full
-    if(app->favorites_count >= 50) {
-        return false; // Favorites list is full
-    }
-    
-    // Add word to favorites
-    app->favorites[app->favorites_count] = word_index;
-    app->favorites_count++;
+    dictionary_app_save(app, DictionaryJournalFavoriteAdd, word_index);
     return true;
 }
 
 // Helper function to remove a word from favorites
 static bool remove_from_favorites(DictionaryApp* app, uint32_t word_index) {
-    // Find the word in favorites
-    for(uint8_t i = 0; i < app->favorites_count; i++) {
-        if(app->favorites[i] == word_index) {
-            // Remove by shifting all elements after it
-            for(uint8_t j = i; j < app->favorites_count - 1; j++) {
-                app->favorites[j] = app->favorites[j + 1];
-            }
-            app->favorites_count--;
-            
-            // Adjust current_favorite_index if needed
-            if(app->current_favorite_index >= app->favorites_count && app->favorites_count > 0) {
-                app->current_favorite_index = app->favorites_count - 1;
-            }
-            
-            return true; // Successfully removed
-        }
+    if(!dictionary_favorites_remove(app->favorites, word_index)) {
+        return false; // Word was not in favorites
     }
-    return false; // Word was not in favorites
+    dictionary_app_save(app, DictionaryJournalFavoriteRemove, word_index);
+
+    // Adjust current_favorite_index if needed
+    uint32_t count = dictionary_favorites_get_count(app->favorites);
+    if(app->current_favorite_index >= count && count > 0) {
+        app->current_favorite_index = count - 1;
+    }
+    return true;
 }
 
 // Free resources used by the application
 static void dictionary_app_free(DictionaryApp* app) {
+    // Stop the search worker first, it posts to the event queue
+    if(app->search != NULL) {
+        dictionary_search_free(app->search);
+        app->search = NULL;
+    }
+
     // Free GUI resources
+    gui_remove_framebuffer_callback(app->gui, dictionary_ui_framebuffer_callback, app);
     gui_remove_view_port(app->gui, app->view_port);
     view_port_free(app->view_port);
     furi_record_close(RECORD_GUI);
@@ -119,17 +556,427 @@ static void dictionary_app_free(DictionaryApp* app) {
 
     // Free event queue
     furi_message_queue_free(app->event_queue);
-    
-    // Free search results if allocated
-    if(app->search_results != NULL) {
-        free(app->search_results);
-        app->search_results = NULL;
-    }
+    furi_mutex_free(app->mutex);
 
     // Clean up dictionary data
+    if(app->journal != NULL) {
+        dictionary_journal_close(app->journal);
+        app->journal = NULL;
+    }
+    free(app->unresolved_favorites.words);
+    free(app->unresolved_history.words);
+    if(app->storage != NULL) {
+        furi_record_close(RECORD_STORAGE);
+        app->storage = NULL;
+    }
+    if(app->favorites != NULL) {
+        dictionary_favorites_free(app->favorites);
+        app->favorites = NULL;
+    }
+    if(app->layout != NULL) {
+        dictionary_layout_free(app->layout);
+        app->layout = NULL;
+    }
+    if(app->word_list != NULL) {
+        dictionary_list_free(app->word_list);
+        dictionary_list_free(app->result_list);
+        dictionary_list_free(app->favorite_list);
+        app->word_list = NULL;
+    }
     dictionary_data_free();
 }
 
+// Move a list position back by up to steps, returns false if it stayed
+static bool dictionary_app_step_back(uint32_t* position, uint32_t steps) {
+    if(*position == 0) return false;
+    *position -= steps < *position ? steps : *position;
+    return true;
+}
+
+// Move a list position forward by up to steps within count items, returns
+// false if it stayed
+static bool dictionary_app_step_forward(uint32_t* position, uint32_t steps, uint32_t count) {
+    if(*position + 1 >= count) return false;
+    *position = steps < count - 1 - *position ? *position + steps : count - 1;
+    return true;
+}
+
+// Check if an event only moves through a list, so repeats of it can be merged
+static bool dictionary_app_is_navigation(const InputEvent* event) {
+    return event->type == InputTypeRepeat ||
+           (event->type == InputTypePress && (event->key == InputKeyUp || event->key == InputKeyDown));
+}
+
+// Check if an event acts as a press: holding Up or Down steps again
+static bool dictionary_app_is_press(const InputEvent* event) {
+    return event->type == InputTypePress ||
+           (event->type == InputTypeRepeat && (event->key == InputKeyUp || event->key == InputKeyDown));
+}
+
+// Move through the main list while Up or Down is held: a word per repeat at
+// first, then a page, then a run of words sharing their first two letters
+static bool dictionary_app_scroll(DictionaryApp* app, bool forward, uint32_t repeat) {
+    uint32_t count = dictionary_data_get_word_count();
+    uint32_t old_index = app->current_word_index;
+    for(uint32_t i = 0; i < repeat; i++) {
+        app->scroll_repeats++;
+        uint32_t steps = app->scroll_repeats <= DICTIONARY_APP_WORD_REPEATS ? 1 : DICTIONARY_APP_PAGE_WORDS;
+        if(app->scroll_repeats > DICTIONARY_APP_PAGE_REPEATS) {
+            // Runs can be shorter than a page, the speed never drops
+            uint32_t index = app->current_word_index;
+            uint32_t target = forward ? dictionary_data_get_next_bucket(index, true) :
+                                        dictionary_data_get_previous_bucket(index, true);
+            uint32_t distance = forward ? target - index : index - target;
+            if(distance > steps) {
+                steps = distance;
+            }
+        }
+        if(forward) {
+            dictionary_app_step_forward(&app->current_word_index, steps, count);
+        } else {
+            dictionary_app_step_back(&app->current_word_index, steps);
+        }
+    }
+    return app->current_word_index != old_index;
+}
+
+// Jump to the first word of the next or previous first letter, or of the
+// current one when the selection is inside it
+static bool dictionary_app_jump_letter(DictionaryApp* app, bool forward, uint32_t repeat) {
+    uint32_t count = dictionary_data_get_word_count();
+    uint32_t old_index = app->current_word_index;
+    for(uint32_t i = 0; i < repeat; i++) {
+        uint32_t index = app->current_word_index;
+        if(forward) {
+            index = dictionary_data_get_next_bucket(index, false);
+            if(index >= count) break;
+        } else {
+            index = dictionary_data_get_previous_bucket(index, false);
+        }
+        app->current_word_index = index;
+    }
+    return app->current_word_index != old_index;
+}
+
+#if DICTIONARY_PROFILE
+// Apply a press in the profile view: Up and Down scroll, OK saves, Left
+// starts counting afresh and Back returns to the word view
+static bool dictionary_app_handle_profile_event(DictionaryApp* app, const InputEvent* event, uint32_t repeat) {
+    if(!dictionary_app_is_press(event)) return false;
+
+    if(event->key == InputKeyUp) {
+        return dictionary_app_step_back(&app->profile_position, repeat);
+    } else if(event->key == InputKeyDown) {
+        uint32_t lines = dictionary_profile_get_line_count();
+        return dictionary_app_step_forward(&app->profile_position, repeat, lines - DICTIONARY_APP_TEXT_LINES + 1);
+    } else if(event->key == InputKeyOk) {
+        bool saved = dictionary_profile_save(app->storage, DICTIONARY_APP_PROFILE_PATH);
+        app->profile_status = saved ? "Saved" : "Save failed";
+    } else if(event->key == InputKeyLeft) {
+        dictionary_profile_reset();
+        app->profile_status = NULL;
+    } else if(event->key == InputKeyBack) {
+        app->showing_profile = false;
+    }
+    return true;
+}
+#endif
+
+// Apply one input event, or repeat presses of the same navigation key.
+// Returns true if anything on screen changed.
+static bool dictionary_app_handle_event(DictionaryApp* app, const InputEvent* event, uint32_t repeat, bool* running) {
+    // Releases leave the screen as it is, and only the main list tells short
+    // and long presses apart
+    if(event->type == InputTypeRelease) return false;
+    bool main_list =
+        !app->is_searching && !app->showing_definition && !app->showing_search_results && !app->showing_favorites;
+    if(!main_list && !dictionary_app_is_press(event)) return false;
+    bool changed = true;
+    uint32_t old_index = app->current_word_index;
+
+#if DICTIONARY_PROFILE
+    if(app->showing_profile) {
+        return dictionary_app_handle_profile_event(app, event, repeat);
+    }
+#endif
+
+    // Process input based on current state
+    if(app->is_searching) {
+        // Process input for search mode
+        if(dictionary_app_is_press(event)) {
+            if(event->key == InputKeyOk) {
+                app->is_searching = false;
+                if(app->search_term_length > 0) {
+                    if(app->search_mode == DictionarySearchRussian) {
+                        // Translations were narrowed letter by letter
+                        DictionaryPrefix* range = &app->search_prefix[app->search_term_length];
+                        app->search_results_first = range->first;
+                        app->search_results_count = range->last - range->first;
+                        app->search_results_source = DictionaryResultsTranslations;
+                    } else if(app->search_mode == DictionarySearchText) {
+                        // The matches have been coming in since the last letter
+                        app->search_results_source = DictionaryResultsDefinitions;
+                    } else {
+                        // Words are sorted, so the matches form a range
+                        DictionaryPrefix* prefix = &app->search_prefix[app->search_term_length];
+                        app->search_results_first = prefix->first;
+                        app->search_results_count = prefix->last - prefix->first;
+                        app->search_results_source = DictionaryResultsWords;
+
+                        // Nothing starts with the term, offer the closest words instead
+                        if(app->search_results_count == 0) {
+                            app->search_results_source = DictionaryResultsSuggestions;
+                            dictionary_app_submit_search(app, DictionarySearchQuerySuggestions);
+                        } else {
+                            dictionary_app_submit_search(app, DictionarySearchQueryCompletions);
+                        }
+                    }
+
+                    // Results still coming in are shown as they arrive
+                    if(app->search_results_count > 0 || !app->search_done) {
+                        // Show search results
+                        app->showing_search_results = true;
+                        app->current_search_index = 0;
+                    } else {
+                        // No results found, show a message
+                        app->showing_definition = true;
+                        strcpy(app->search_term, "No results found");
+                        app->scroll_position = 0;
+                    }
+                }
+            } else if(event->key == InputKeyBack) {
+                if(app->search_term_length > 0) {
+                    dictionary_app_remove_letter(app);
+                } else {
+                    app->is_searching = false;
+                }
+            } else if(event->key == InputKeyUp) {
+                // Navigate through alphabet - go to previous letter
+                changed = app->search_term_length > 0 && dictionary_app_cycle_letter(app, false, repeat);
+            } else if(event->key == InputKeyDown) {
+                // Navigate through alphabet - go to next letter
+                changed = app->search_term_length > 0 && dictionary_app_cycle_letter(app, true, repeat);
+            } else if(event->key == InputKeyRight) {
+                // Add new letter, the first one that leads to a match
+                uint8_t size = dictionary_app_get_letter_size(app);
+                changed = false;
+                if(app->search_term_length + size < sizeof(app->search_term)) {
+                    uint32_t letters = dictionary_app_get_next_letters(app);
+                    if(letters != 0) {
+                        uint8_t alphabet_size = dictionary_app_get_alphabet_size(app);
+                        app->search_letters[app->search_term_length] = letters;
+                        app->search_term_length += size;
+                        app->search_term[app->search_term_length] = '\0';
+                        dictionary_app_set_last_letter(
+                            app, dictionary_app_step_letter(letters, alphabet_size - 1, alphabet_size, true));
+                        changed = true;
+                    }
+                }
+            } else if(event->key == InputKeyLeft) {
+                if(app->search_term_length > 0) {
+                    // Remove last letter
+                    dictionary_app_remove_letter(app);
+                } else {
+                    // Cycle through English, Russian and full-text search
+                    if(app->search_mode == DictionarySearchEnglish) {
+                        app->search_mode = DictionarySearchRussian;
+                    } else if(app->search_mode == DictionarySearchRussian) {
+                        app->search_mode = DictionarySearchText;
+                    } else {
+                        app->search_mode = DictionarySearchEnglish;
+                    }
+                    dictionary_app_start_search(app);
+                }
+            }
+        }
+    } else if(app->showing_definition) {
+        // Process input for definition view
+        if(dictionary_app_is_press(event)) {
+            if(event->key == InputKeyOk || event->key == InputKeyBack) {
+                app->showing_definition = false;
+            } else if(event->key == InputKeyLeft) {
+                // Toggle between definition and translation
+                app->show_translation = !app->show_translation;
+                app->scroll_position = 0; // Reset scroll when switching modes
+            } else if(event->key == InputKeyUp) {
+                changed = app->scroll_position > 0;
+                app->scroll_position -= repeat < app->scroll_position ? repeat : app->scroll_position;
+                // Scrolling the text up is taken as heading back up the list
+                app->prefetch_pending = true;
+                app->prefetch_forward = false;
+            } else if(event->key == InputKeyDown) {
+                // The text shown was wrapped when it was first drawn
+                const DictionaryLayoutText* wrapped =
+                    dictionary_layout_get(app->layout, app->current_word_index, app->show_translation);
+                uint32_t old_position = app->scroll_position;
+                if(wrapped->line_count > DICTIONARY_APP_TEXT_LINES) {
+                    app->scroll_position += repeat;
+                    if(app->scroll_position > (uint32_t)(wrapped->line_count - DICTIONARY_APP_TEXT_LINES)) {
+                        app->scroll_position = wrapped->line_count - DICTIONARY_APP_TEXT_LINES;
+                    }
+                }
+                changed = app->scroll_position != old_position;
+                app->prefetch_pending = true;
+                app->prefetch_forward = true;
+#if DICTIONARY_PROFILE
+            } else if(event->key == InputKeyRight) {
+                app->showing_profile = true;
+                app->profile_position = 0;
+                app->profile_status = NULL;
+#endif
+            }
+        }
+    } else if(app->showing_search_results) {
+        // Search results navigation
+        if(dictionary_app_is_press(event)) {
+            if(event->key == InputKeyOk) {
+                changed = app->search_results_count > 0;
+                if(app->search_results_count > 0) {
+                    // Show definition of the selected search result
+                    app->current_word_index = dictionary_app_get_search_result(app, app->current_search_index);
+                    
+                    // Get the word from index and copy it to search_term for showing definition
+                    const char* word = dictionary_data_get_word(app->current_word_index);
+                    strncpy(app->search_term, word, sizeof(app->search_term) - 1);
+                    app->search_term[sizeof(app->search_term) - 1] = '\0';
+                    app->search_term_length = strlen(app->search_term);
+                    
+                    // Russian searches open on the translation they matched
+                    if(app->search_results_source == DictionaryResultsTranslations) {
+                        app->show_translation = true;
+                    }
+                    dictionary_app_record_lookup(app, app->current_word_index);
+
+                    // Show definition view
+                    dictionary_app_cancel_search(app);
+                    app->showing_search_results = false;
+                    app->showing_definition = true;
+                    app->scroll_position = 0;
+                }
+            } else if(event->key == InputKeyBack) {
+                // Exit search results mode
+                dictionary_app_cancel_search(app);
+                app->showing_search_results = false;
+                app->search_results_count = 0;
+            } else if(event->key == InputKeyUp) {
+                // Navigate to previous search result
+                changed = dictionary_app_step_back(&app->current_search_index, repeat);
+            } else if(event->key == InputKeyDown) {
+                // Navigate to next search result
+                changed = dictionary_app_step_forward(&app->current_search_index, repeat, app->search_results_count);
+            } else if(event->key == InputKeyRight) {
+                // Add current search result to favorites
+                changed = false;
+                if(app->search_results_count > 0) {
+                    uint32_t word_index = dictionary_app_get_search_result(app, app->current_search_index);
+                    changed = add_to_favorites(app, word_index);
+                }
+            }
+        }
+    } else if(app->showing_favorites) {
+        // Favorites list navigation
+        if(dictionary_app_is_press(event)) {
+            if(event->key == InputKeyOk) {
+                changed = dictionary_app_get_list_count(app) > 0;
+                if(changed) {
+                    // Show definition of the selected favorite
+                    app->current_word_index = dictionary_app_get_list_item(app, app->current_favorite_index);
+                    
+                    // Get the word from index and copy it to search_term for showing definition
+                    const char* word = dictionary_data_get_word(app->current_word_index);
+                    strncpy(app->search_term, word, sizeof(app->search_term) - 1);
+                    app->search_term[sizeof(app->search_term) - 1] = '\0';
+                    app->search_term_length = strlen(app->search_term);
+                    
+                    app->showing_definition = true;
+                    app->scroll_position = 0;
+                }
+            } else if(event->key == InputKeyBack) {
+                // Exit favorites mode
+                app->showing_favorites = false;
+            } else if(event->key == InputKeyUp) {
+                // Navigate to previous favorite
+                changed = dictionary_app_step_back(&app->current_favorite_index, repeat);
+            } else if(event->key == InputKeyDown) {
+                // Navigate to next favorite
+                changed = dictionary_app_step_forward(
+                    &app->current_favorite_index, repeat, dictionary_app_get_list_count(app));
+            } else if(event->key == InputKeyRight) {
+                // Remove from favorites
+                changed = false;
+                if(!app->showing_history && dictionary_favorites_get_count(app->favorites) > 0) {
+                    uint32_t word_index =
+                        dictionary_favorites_get(app->favorites, app->current_favorite_index);
+                    changed = remove_from_favorites(app, word_index);
+                }
+            } else if(event->key == InputKeyLeft) {
+                // Switch between favorites and recent lookups
+                app->showing_history = !app->showing_history;
+                app->current_favorite_index = 0;
+            }
+        }
+    } else {
+        // Main dictionary navigation. Left and Right act on release, so
+        // holding them can jump between letters instead
+        if(event->type == InputTypeRepeat && (event->key == InputKeyUp || event->key == InputKeyDown)) {
+            changed = dictionary_app_scroll(app, event->key == InputKeyDown, repeat);
+        } else if(
+            (event->type == InputTypeLong || event->type == InputTypeRepeat) &&
+            (event->key == InputKeyLeft || event->key == InputKeyRight)) {
+            changed = dictionary_app_jump_letter(app, event->key == InputKeyRight, repeat);
+        } else if(event->type == InputTypeShort && event->key == InputKeyRight) {
+            // Toggle favorite status for current word
+            if(dictionary_data_get_word_count() == 0) {
+                // Nothing to mark in an empty dictionary
+                changed = false;
+            } else if(!remove_from_favorites(app, app->current_word_index)) {
+                add_to_favorites(app, app->current_word_index);
+            }
+        } else if(event->type == InputTypeShort && event->key == InputKeyLeft) {
+            // Show favorites
+            app->showing_favorites = true;
+            app->showing_history = false;
+            app->current_favorite_index = 0;
+        } else if(event->type == InputTypePress) {
+            if(event->key == InputKeyOk) {
+                // Start searching
+                app->is_searching = true;
+                
+                // Initialize search term with empty string
+                app->search_term[0] = '\0';
+                app->search_term_length = 0;
+                dictionary_app_start_search(app);
+                
+                // Cancel any previous search results
+                app->showing_search_results = false;
+                app->search_results_count = 0;
+            } else if(event->key == InputKeyBack) {
+                // Exit application
+                *running = false;
+            } else if(event->key == InputKeyUp) {
+                // Navigate to previous word, holding the key speeds up
+                app->scroll_repeats = 0;
+                changed = dictionary_app_step_back(&app->current_word_index, repeat);
+            } else if(event->key == InputKeyDown) {
+                // Navigate to next word
+                app->scroll_repeats = 0;
+                changed =
+                    dictionary_app_step_forward(&app->current_word_index, repeat, dictionary_data_get_word_count());
+            } else {
+                changed = false;
+            }
+        } else {
+            changed = false;
+        }
+    }
+
+    if(app->current_word_index != old_index) {
+        app->prefetch_pending = true;
+        app->prefetch_forward = app->current_word_index > old_index;
+    }
+    return changed;
+}
+
 // Main application entry point
 int32_t dictionary_app(void* p) {
     UNUSED(p);
@@ -147,262 +994,65 @@ int32_t dictionary_app(void* p) {
     // Notify user that application started
     notification_message(app->notifications, &sequence_display_backlight_on);
 
-    // Main event loop
-    InputEvent event;
+    // Main event loop: wait for input, then drain the queue in one batch
+    DictionaryEvent event;
     bool running = true;
-    
+
     while(running) {
-        // Get next input event
-        FuriStatus status = furi_message_queue_get(app->event_queue, &event, 100);
-        
-        if(status == FuriStatusError) {
+        if(furi_message_queue_get(app->event_queue, &event, FuriWaitForever) != FuriStatusOk) {
             // Exit if there was an error
             running = false;
-            printf("Application exiting due to error...\n");
+            FURI_LOG_E(TAG, "Event queue failed, exiting");
             continue;
         }
-        
-        // Only process events if we got a valid input (not a timeout)
-        if(status == FuriStatusOk) {
-            // Debug log for input events
-            printf("Got input: type=%d, key=%d\n", event.type, event.key);
-            
-            // Process input based on current state
-            if(app->is_searching) {
-                // Process input for search mode
-                if(event.type == InputTypePress) {
-                    if(event.key == InputKeyOk) {
-                        app->is_searching = false;
-                        if(app->search_term_length > 0) {
-                            // Free previous search results if any
-                            if(app->search_results != NULL) {
-                                free(app->search_results);
-                                app->search_results = NULL;
-                            }
-                            
-                            // Perform search with the entered term as prefix
-                            app->search_results_count = dictionary_data_find_words_with_prefix(
-                                app->search_term, &app->search_results);
-                                
-                            if(app->search_results_count > 0) {
-                                // Show search results
-                                app->showing_search_results = true;
-                                app->current_search_index = 0;
-                            } else {
-                                // No results found, show a message
-                                app->showing_definition = true;
-                                strcpy(app->search_term, "No results found");
-                                app->scroll_position = 0;
-                            }
-                        }
-                    } else if(event.key == InputKeyBack) {
-                        if(app->search_term_length > 0) {
-                            app->search_term_length--;
-                            app->search_term[app->search_term_length] = '\0';
-                        } else {
-                            app->is_searching = false;
-                        }
-                    } else if(event.key == InputKeyUp) {
-                        // Navigate through alphabet - go to previous letter
-                        if(app->search_term_length > 0) {
-                            char current = app->search_term[app->search_term_length - 1];
-                            if(current > 'a') {
-                                app->search_term[app->search_term_length - 1]--;
-                            } else {
-                                app->search_term[app->search_term_length - 1] = 'z';
-                            }
-                        }
-                    } else if(event.key == InputKeyDown) {
-                        // Navigate through alphabet - go to next letter
-                        if(app->search_term_length > 0) {
-                            char current = app->search_term[app->search_term_length - 1];
-                            if(current < 'z') {
-                                app->search_term[app->search_term_length - 1]++;
-                            } else {
-                                app->search_term[app->search_term_length - 1] = 'a';
-                            }
-                        }
-                    } else if(event.key == InputKeyRight) {
-                        // Add new letter
-                        if(app->search_term_length < 31) {
-                            app->search_term[app->search_term_length] = 'a';
-                            app->search_term_length++;
-                            app->search_term[app->search_term_length] = '\0';
-                        }
-                    } else if(event.key == InputKeyLeft) {
-                        // Remove last letter
-                        if(app->search_term_length > 0) {
-                            app->search_term_length--;
-                            app->search_term[app->search_term_length] = '\0';
-                        }
-                    }
-                }
-            } else if(app->showing_definition) {
-                // Process input for definition view
-                if(event.type == InputTypePress) {
-                    if(event.key == InputKeyOk || event.key == InputKeyBack) {
-                        app->showing_definition = false;
-                    } else if(event.key == InputKeyLeft) {
-                        // Toggle between definition and translation
-                        app->show_translation = !app->show_translation;
-                        app->scroll_position = 0; // Reset scroll when switching modes
-                    } else if(event.key == InputKeyUp) {
-                        if(app->scroll_position > 0) {
-                            app->scroll_position--;
-                        }
-                    } else if(event.key == InputKeyDown) {
-                        // Get the current word and its text (definition or translation)
-                        const char* word = dictionary_data_get_word(app->current_word_index);
-                        const char* text;
-                        
-                        if(app->show_translation) {
-                            text = dictionary_data_get_translation_by_index(app->current_word_index);
-                        } else {
-                            text = dictionary_data_get_definition(word);
-                        }
-                        
-                        int lines = dictionary_ui_count_lines(text);
-                        int max_lines = 4; // Maximum visible lines on screen
-                        
-                        if((int)app->scroll_position < lines - max_lines) {
-                            app->scroll_position++;
-                        }
-                    }
-                }
-            } else if(app->showing_search_results) {
-                // Search results navigation
-                if(event.type == InputTypePress) {
-                    if(event.key == InputKeyOk) {
-                        if(app->search_results_count > 0) {
-                            // Show definition of the selected search result
-                            app->current_word_index = app->search_results[app->current_search_index];
-                            
-                            // Get the word from index and copy it to search_term for showing definition
-                            const char* word = dictionary_data_get_word(app->current_word_index);
-                            strncpy(app->search_term, word, sizeof(app->search_term) - 1);
-                            app->search_term[sizeof(app->search_term) - 1] = '\0';
-                            app->search_term_length = strlen(app->search_term);
-                            
-                            // Show definition view
-                            app->showing_search_results = false;
-                            app->showing_definition = true;
-                            app->scroll_position = 0;
-                        }
-                    } else if(event.key == InputKeyBack) {
-                        // Exit search results mode
-                        app->showing_search_results = false;
-                        
-                        // Free search results
-                        if(app->search_results != NULL) {
-                            free(app->search_results);
-                            app->search_results = NULL;
-                            app->search_results_count = 0;
-                        }
-                    } else if(event.key == InputKeyUp) {
-                        // Navigate to previous search result
-                        if(app->current_search_index > 0 && app->search_results_count > 0) {
-                            app->current_search_index--;
-                        }
-                    } else if(event.key == InputKeyDown) {
-                        // Navigate to next search result
-                        if(app->current_search_index < app->search_results_count - 1) {
-                            app->current_search_index++;
-                        }
-                    } else if(event.key == InputKeyRight) {
-                        // Add current search result to favorites
-                        if(app->search_results_count > 0) {
-                            uint32_t word_index = app->search_results[app->current_search_index];
-                            add_to_favorites(app, word_index);
-                        }
-                    }
-                }
-            } else if(app->showing_favorites) {
-                // Favorites list navigation
-                if(event.type == InputTypePress) {
-                    if(event.key == InputKeyOk) {
-                        if(app->favorites_count > 0) {
-                            // Show definition of the selected favorite
-                            app->current_word_index = app->favorites[app->current_favorite_index];
-                            
-                            // Get the word from index and copy it to search_term for showing definition
-                            const char* word = dictionary_data_get_word(app->current_word_index);
-                            strncpy(app->search_term, word, sizeof(app->search_term) - 1);
-                            app->search_term[sizeof(app->search_term) - 1] = '\0';
-                            app->search_term_length = strlen(app->search_term);
-                            
-                            app->showing_definition = true;
-                            app->scroll_position = 0;
-                        }
-                    } else if(event.key == InputKeyBack) {
-                        // Exit favorites mode
-                        app->showing_favorites = false;
-                    } else if(event.key == InputKeyUp) {
-                        // Navigate to previous favorite
-                        if(app->current_favorite_index > 0 && app->favorites_count > 0) {
-                            app->current_favorite_index--;
-                        }
-                    } else if(event.key == InputKeyDown) {
-                        // Navigate to next favorite
-                        if(app->current_favorite_index < app->favorites_count - 1) {
-                            app->current_favorite_index++;
-                        }
-                    } else if(event.key == InputKeyRight) {
-                        // Remove from favorites
-                        if(app->favorites_count > 0) {
-                            uint32_t word_index = app->favorites[app->current_favorite_index];
-                            remove_from_favorites(app, word_index);
-                        }
-                    }
-                }
+
+        // The search worker waits while a batch is handled
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        DICTIONARY_PROFILE_BEGIN(batch_start);
+        bool dirty = false;
+        bool has_event = true;
+        while(running && has_event) {
+            // Presses of the same navigation key queued back to back become one step
+            DictionaryEvent next;
+            uint32_t repeat = 1;
+            has_event = furi_message_queue_get(app->event_queue, &next, 0) == FuriStatusOk;
+            while(has_event && event.type == DictionaryEventInput && next.type == DictionaryEventInput &&
+                  dictionary_app_is_navigation(&event.input) && next.input.type == event.input.type &&
+                  next.input.key == event.input.key) {
+                repeat++;
+                has_event = furi_message_queue_get(app->event_queue, &next, 0) == FuriStatusOk;
+            }
+
+            if(event.type == DictionaryEventSearch) {
+                // The callback stored the results already
+                app->search_event_pending = false;
+                dirty = true;
+            } else if(event.type == DictionaryEventRedraw) {
+                // The draw callback showed an old frame
+                dirty = true;
             } else {
-                // Main dictionary navigation
-                if(event.type == InputTypePress) {
-                    if(event.key == InputKeyOk) {
-                        // Start searching
-                        app->is_searching = true;
-                        
-                        // Initialize search term with empty string
-                        app->search_term[0] = '\0';
-                        app->search_term_length = 0;
-                        
-                        // Cancel any previous search results
-                        app->showing_search_results = false;
-                        if(app->search_results != NULL) {
-                            free(app->search_results);
-                            app->search_results = NULL;
-                            app->search_results_count = 0;
-                        }
-                    } else if(event.key == InputKeyBack) {
-                        // Exit application
-                        running = false;
-                    } else if(event.key == InputKeyUp) {
-                        // Navigate to previous word
-                        if(app->current_word_index > 0) {
-                            app->current_word_index--;
-                        }
-                    } else if(event.key == InputKeyDown) {
-                        // Navigate to next word
-                        if(app->current_word_index < dictionary_data_get_word_count() - 1) {
-                            app->current_word_index++;
-                        }
-                    } else if(event.key == InputKeyRight) {
-                        // Toggle favorite status for current word
-                        if(is_word_favorite(app, app->current_word_index)) {
-                            remove_from_favorites(app, app->current_word_index);
-                        } else {
-                            add_to_favorites(app, app->current_word_index);
-                        }
-                    } else if(event.key == InputKeyLeft) {
-                        // Show favorites
-                        app->showing_favorites = true;
-                        app->current_favorite_index = 0;
-                    }
-                }
+                dirty |= dictionary_app_handle_event(app, &event.input, repeat, &running);
             }
-            
-            // Update the display
+            event = next;
+        }
+        DICTIONARY_PROFILE_END(DictionaryProfileEvent, batch_start);
+        furi_mutex_release(app->mutex);
+
+        // Redraw once per batch, and only if something changed
+        if(running && dirty) {
             view_port_update(app->view_port);
         }
+
+        // Read ahead while no input waits, after the frame had its turn to draw
+        if(running && app->prefetch_pending) {
+            furi_thread_yield();
+            if(furi_message_queue_get_count(app->event_queue) == 0) {
+                furi_mutex_acquire(app->mutex, FuriWaitForever);
+                app->prefetch_pending = false;
+                dictionary_data_prefetch(app->current_word_index, app->prefetch_forward);
+                furi_mutex_release(app->mutex);
+            }
+        }
     }
 
     // Clean up
@@ -1,11 +1,79 @@
 #pragma once
 
 #include "furi.h"
+#include "dictionary_data.h"
+#include "dictionary_favorites.h"
+#include "dictionary_journal.h"
+#include "dictionary_layout.h"
+#include "dictionary_list.h"
+#include "dictionary_profile.h"
+#include "dictionary_search.h"
 #include "gui/gui.h"
 #include "gui/view_dispatcher.h"
 #include "gui/scene_manager.h"
 #include "notification/notification_messages.h"
 
+// Input events buffered between two batches of the event loop
+#define DICTIONARY_APP_EVENT_QUEUE_SIZE 16
+
+// Words in a page of the main list, and the repeats of a held Up or Down
+// after which it moves by pages, then by runs of words sharing two letters
+#define DICTIONARY_APP_PAGE_WORDS 5
+#define DICTIONARY_APP_WORD_REPEATS 4
+#define DICTIONARY_APP_PAGE_REPEATS 12
+
+// Lines of a definition or translation shown at a time in the word view
+#define DICTIONARY_APP_TEXT_LINES 4
+
+// Most "did you mean" suggestions offered when a search finds nothing
+#define DICTIONARY_APP_SUGGESTIONS_MAX 8
+
+// Most frequent completions listed ahead of the other words of a prefix
+#define DICTIONARY_APP_COMPLETIONS_MAX 5
+
+// Most full-text matches kept for browsing, the total is still counted
+#define DICTIONARY_APP_DEFINITION_RESULTS_MAX 32
+
+// Most recent lookups kept in the history
+#define DICTIONARY_APP_HISTORY_MAX 32
+
+// Bytes of a frame of the 128x64 display, a bit per pixel
+#define DICTIONARY_APP_FRAME_SIZE (128 * 64 / 8)
+
+// Words packed one after another, each ending in '\0'
+typedef struct {
+    char* words;
+    size_t size;
+    uint32_t count;
+} DictionaryAppWords;
+
+// Language of the search term
+typedef enum {
+    DictionarySearchEnglish, // Words starting with the term
+    DictionarySearchRussian, // Translations starting with the term
+    DictionarySearchText,    // Definitions containing every word of the term
+} DictionarySearchMode;
+
+// Where the search results come from
+typedef enum {
+    DictionaryResultsWords,        // Range of words
+    DictionaryResultsTranslations, // Range of the reverse index
+    DictionaryResultsSuggestions,  // "Did you mean" list
+    DictionaryResultsDefinitions,  // Full-text matches
+} DictionaryResultsSource;
+
+// Kinds of events in the app's queue
+typedef enum {
+    DictionaryEventInput,  // Key event from the GUI thread
+    DictionaryEventSearch, // The search worker has new results
+    DictionaryEventRedraw, // A frame was drawn again while the search worker held the mutex
+} DictionaryEventType;
+
+typedef struct {
+    DictionaryEventType type;
+    InputEvent input;
+} DictionaryEvent;
+
 // Define the main dictionary application structure
 typedef struct {
     Gui* gui;
@@ -14,31 +82,96 @@ typedef struct {
     FuriMessageQueue* event_queue;
     NotificationApp* notifications;
 
+    // Last frame sent to the display, drawn again when the search worker
+    // holds the mutex. Only the GUI thread touches it.
+    uint8_t frame[DICTIONARY_APP_FRAME_SIZE];
+    bool frame_valid;
+
+    // Guards the state below and the dictionary data, shared by the event
+    // loop, the draw callback and the search worker
+    FuriMutex* mutex;
+    DictionarySearch* search;
+    uint32_t search_query;     // Query whose results are shown, 0 for none
+    bool search_done;          // Its results are final
+    bool search_event_pending; // A DictionaryEventSearch is queued already
+
     // Search state
     char search_term[32];
-    uint8_t search_term_length;
+    uint8_t search_term_length;     // In bytes, Russian letters take two
+    DictionarySearchMode search_mode;
+    DictionaryPrefix search_prefix[32]; // Matches after each letter, by term length in bytes
+    uint32_t search_letters[32]; // Letters that continue the term, by term length in bytes
+    // Where the translations going on with each letter start, for the term
+    // of search_starts_length bytes. Picking the next letter takes its run.
+    uint32_t search_starts[DICTIONARY_DATA_RUSSIAN_LETTERS + 1];
+    uint8_t search_starts_length; // UINT8_MAX if there are none
     bool showing_definition;
 
     // Navigation state
     uint32_t current_word_index;
     uint32_t scroll_position;
+    uint32_t scroll_repeats; // Repeats since Up or Down was pressed in the main list
+    bool prefetch_pending;   // The selection moved or scrolled since blocks were read ahead of it
+    bool prefetch_forward;   // It went down the list
     bool is_searching;
+    DictionaryLayout* layout; // Wrapped texts of the word view
+
+    // Rows of the main, search results and favorites lists
+    DictionaryList* word_list;
+    DictionaryList* result_list;
+    DictionaryList* favorite_list;
     
     // Favorites functionality
     bool showing_favorites;        // Flag to show if in favorites view
-    uint32_t favorites[50];        // Store indices of favorite words (max 50)
-    uint8_t favorites_count;       // Number of favorites saved
-    uint8_t current_favorite_index; // Current position in favorites list
+    bool showing_history;          // Favorites view lists the recent lookups instead
+    DictionaryFavorites* favorites; // Favorite words, by word index
+    uint32_t current_favorite_index; // Current position in favorites list
+    uint32_t history[DICTIONARY_APP_HISTORY_MAX]; // Recent lookups, newest first
+    uint32_t history_count;
+
+    // Favorites and history saved on storage, NULL if it is unavailable
+    Storage* storage;
+    DictionaryJournal* journal;
+
+    // Saved favorites and lookups, oldest first, of words missing from this
+    // dictionary. They are written back whenever the journal is rewritten,
+    // so they come back with a dictionary that has them.
+    DictionaryAppWords unresolved_favorites;
+    DictionaryAppWords unresolved_history;
     
     // Search results functionality
     bool showing_search_results;   // Flag to show search results
-    uint32_t* search_results;      // Array of indices for search results
+    DictionaryResultsSource search_results_source;
+    uint32_t search_results_first; // Start of the range of matches
     uint32_t search_results_count; // Number of search results
     uint32_t current_search_index; // Current position in search results
+    uint32_t search_results_total; // Full-text matches, including those not kept
+    DictionaryMatch suggestions[DICTIONARY_APP_SUGGESTIONS_MAX]; // Closest words to a search term without matches
+    uint32_t definition_results[DICTIONARY_APP_DEFINITION_RESULTS_MAX]; // First full-text matches
+    DictionaryRankedWord completions[DICTIONARY_APP_COMPLETIONS_MAX]; // Most frequent words of the range
+    uint32_t completion_indices[DICTIONARY_APP_COMPLETIONS_MAX]; // The same words in word order
+    uint8_t completion_count;
     
     // Translation functionality
     bool show_translation;         // Flag to toggle between definition/translation
+
+#if DICTIONARY_PROFILE
+    // Profile view, opened with Right from the word view
+    bool showing_profile;
+    uint32_t profile_position;  // First summary line shown
+    const char* profile_status; // Outcome of the last save, NULL before one
+#endif
 } DictionaryApp;
 
+// Get the word index of a search result, from the prefix range (its most
+// frequent words first), the suggestions or the full-text matches
+uint32_t dictionary_app_get_search_result(DictionaryApp* app, uint32_t position);
+
+// Get the number of words in the favorites view, favorites or history
+uint32_t dictionary_app_get_list_count(DictionaryApp* app);
+
+// Get the word index at a position of the favorites view
+uint32_t dictionary_app_get_list_item(DictionaryApp* app, uint32_t position);
+
 // Main entry point for the application
 int32_t dictionary_app(void* p);
@@ -0,0 +1,194 @@
+#include "dictionary_codec.h"
+#include "dictionary_format.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Codes up to this many bits are decoded with a single table lookup
+#define DICTIONARY_CODEC_FAST_BITS 8
+
+struct DictionaryCodec {
+    uint16_t symbol_count;
+    uint16_t max_packed_size;
+
+    // Canonical Huffman tables: codes of each length are consecutive
+    uint16_t length_count[DICTIONARY_CODEC_CODE_MAX + 1];
+    uint16_t first_code[DICTIONARY_CODEC_CODE_MAX + 1];
+    uint16_t first_symbol[DICTIONARY_CODEC_CODE_MAX + 1];
+    uint16_t* symbols; // Ordered by code length, then by value
+
+    // (symbol << 4) | length for every 8-bit prefix, 0 for longer codes
+    uint16_t fast[1 << DICTIONARY_CODEC_FAST_BITS];
+
+    uint16_t* phrase_offsets;
+    uint8_t* phrases;
+};
+
+// Build the decoding tables from the contents of a codec section.
+// Returns NULL if the section is malformed.
+DictionaryCodec* dictionary_codec_alloc(const uint8_t* section, size_t size) {
+    DictionaryFileCodecHeader header;
+    if(size < sizeof(header)) return NULL;
+    memcpy(&header, section, sizeof(header));
+
+    uint16_t phrase_count = header.symbol_count - DICTIONARY_CODEC_LITERALS;
+    if(header.symbol_count < DICTIONARY_CODEC_LITERALS ||
+       phrase_count > DICTIONARY_CODEC_PHRASES_MAX) {
+        return NULL;
+    }
+
+    const uint8_t* lengths = section + sizeof(header);
+    const uint8_t* offsets = lengths + header.symbol_count;
+    size_t phrase_table_size = (phrase_count + 1) * sizeof(uint16_t);
+    if(size < sizeof(header) + header.symbol_count + phrase_table_size) return NULL;
+
+    DictionaryCodec* codec = malloc(sizeof(DictionaryCodec));
+    memset(codec, 0, sizeof(DictionaryCodec));
+    codec->symbol_count = header.symbol_count;
+    codec->max_packed_size = header.max_packed_size;
+    codec->symbols = malloc(header.symbol_count * sizeof(uint16_t));
+    codec->phrase_offsets = malloc(phrase_table_size);
+    memcpy(codec->phrase_offsets, offsets, phrase_table_size);
+
+    size_t phrases_size = size - sizeof(header) - header.symbol_count - phrase_table_size;
+    if(codec->phrase_offsets[phrase_count] > phrases_size) {
+        dictionary_codec_free(codec);
+        return NULL;
+    }
+    codec->phrases = malloc(phrases_size + 1);
+    memcpy(codec->phrases, offsets + phrase_table_size, phrases_size);
+
+    // Count codes per length and assign canonical codes
+    for(uint16_t i = 0; i < header.symbol_count; i++) {
+        if(lengths[i] > DICTIONARY_CODEC_CODE_MAX) {
+            dictionary_codec_free(codec);
+            return NULL;
+        }
+        codec->length_count[lengths[i]]++;
+    }
+    codec->length_count[0] = 0;
+
+    // The lengths must form a prefix code: the codes of each length have to
+    // fit in that many bits
+    uint32_t code = 0;
+    uint16_t index = 0;
+    for(uint8_t length = 1; length <= DICTIONARY_CODEC_CODE_MAX; length++) {
+        if(code + codec->length_count[length] > (1UL << length)) {
+            dictionary_codec_free(codec);
+            return NULL;
+        }
+        codec->first_code[length] = code;
+        codec->first_symbol[length] = index;
+        code = (code + codec->length_count[length]) << 1;
+        index += codec->length_count[length];
+    }
+
+    uint16_t next[DICTIONARY_CODEC_CODE_MAX + 1];
+    memcpy(next, codec->first_symbol, sizeof(next));
+    for(uint16_t i = 0; i < header.symbol_count; i++) {
+        if(lengths[i] > 0) {
+            codec->symbols[next[lengths[i]]++] = i;
+        }
+    }
+
+    // Fill the single lookup table for the short codes
+    for(uint8_t length = 1; length <= DICTIONARY_CODEC_FAST_BITS; length++) {
+        for(uint16_t i = 0; i < codec->length_count[length]; i++) {
+            if(codec->first_code[length] + i >= (1U << length)) {
+                dictionary_codec_free(codec);
+                return NULL;
+            }
+            uint16_t symbol = codec->symbols[codec->first_symbol[length] + i];
+            uint16_t prefix = (codec->first_code[length] + i) << (DICTIONARY_CODEC_FAST_BITS - length);
+            uint16_t fill = 1 << (DICTIONARY_CODEC_FAST_BITS - length);
+            for(uint16_t j = 0; j < fill; j++) {
+                codec->fast[prefix + j] = (symbol << 4) | length;
+            }
+        }
+    }
+
+    return codec;
+}
+
+// Free the decoding tables
+void dictionary_codec_free(DictionaryCodec* codec) {
+    if(codec == NULL) return;
+
+    free(codec->symbols);
+    free(codec->phrase_offsets);
+    free(codec->phrases);
+    free(codec);
+}
+
+// Get the largest compressed block the image contains
+size_t dictionary_codec_get_max_packed_size(DictionaryCodec* codec) {
+    return codec->max_packed_size;
+}
+
+// Decompress a block until it has produced string_count NUL-terminated strings.
+// Returns the number of bytes written, or 0 if the data is corrupt or the
+// output doesn't fit.
+size_t dictionary_codec_decode(
+    DictionaryCodec* codec,
+    const uint8_t* input,
+    size_t input_size,
+    char* output,
+    size_t output_size,
+    uint32_t string_count) {
+    uint32_t bits = 0;      // Pending input bits, most significant first
+    uint8_t bit_count = 0;  // Number of valid bits in the low end of bits
+    size_t position = 0;    // Next input byte
+    size_t written = 0;
+
+    while(string_count > 0) {
+        // Keep at least one full code in the bit buffer, padding with zeroes past the end
+        while(bit_count <= 24) {
+            uint8_t byte = position < input_size ? input[position] : 0;
+            bits = (bits << 8) | byte;
+            bit_count += 8;
+            position++;
+        }
+        if(position > input_size + 4) return 0;
+
+        uint16_t symbol;
+        uint8_t length;
+        uint16_t fast = codec->fast[(bits >> (bit_count - DICTIONARY_CODEC_FAST_BITS)) & 0xFF];
+        if(fast != 0) {
+            symbol = fast >> 4;
+            length = fast & 0x0F;
+        } else {
+            // Walk the canonical code one bit at a time past the table
+            uint16_t code = (bits >> (bit_count - DICTIONARY_CODEC_FAST_BITS)) & 0xFF;
+            length = DICTIONARY_CODEC_FAST_BITS;
+            while(true) {
+                length++;
+                if(length > DICTIONARY_CODEC_CODE_MAX) return 0;
+                code = (code << 1) | ((bits >> (bit_count - length)) & 1);
+                uint16_t offset = code - codec->first_code[length];
+                if(code >= codec->first_code[length] && offset < codec->length_count[length]) {
+                    symbol = codec->symbols[codec->first_symbol[length] + offset];
+                    break;
+                }
+            }
+        }
+        bit_count -= length;
+
+        if(symbol < DICTIONARY_CODEC_LITERALS) {
+            if(written >= output_size) return 0;
+            output[written++] = symbol;
+            if(symbol == '\0') {
+                string_count--;
+            }
+        } else {
+            uint16_t phrase = symbol - DICTIONARY_CODEC_LITERALS;
+            uint16_t start = codec->phrase_offsets[phrase];
+            uint16_t end = codec->phrase_offsets[phrase + 1];
+            if(end < start || (size_t)(end - start) > output_size - written) return 0;
+            memcpy(output + written, codec->phrases + start, end - start);
+            written += end - start;
+        }
+    }
+
+    return written;
+}
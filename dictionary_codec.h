@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Decoder for the compressed text blocks described in dictionary_format.h
+
+typedef struct DictionaryCodec DictionaryCodec;
+
+// Build the decoding tables from the contents of a codec section.
+// Returns NULL if the section is malformed.
+DictionaryCodec* dictionary_codec_alloc(const uint8_t* section, size_t size);
+
+// Free the decoding tables
+void dictionary_codec_free(DictionaryCodec* codec);
+
+// Get the largest compressed block the image contains
+size_t dictionary_codec_get_max_packed_size(DictionaryCodec* codec);
+
+// Decompress a block until it has produced string_count NUL-terminated strings.
+// Returns the number of bytes written, or 0 if the data is corrupt or the
+// output doesn't fit.
+size_t dictionary_codec_decode(
+    DictionaryCodec* codec,
+    const uint8_t* input,
+    size_t input_size,
+    char* output,
+    size_t output_size,
+    uint32_t string_count);
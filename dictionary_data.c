@@ -1,159 +1,1113 @@
 #include "dictionary_data.h"
+#include "dictionary_codec.h"
+#include "dictionary_dawg.h"
+#include "dictionary_fulltext.h"
+#include "dictionary_file.h"
+#include "dictionary_fold.h"
+#include "dictionary_format.h"
+#include "dictionary_fuzzy.h"
+#include "dictionary_profile.h"
+#include "dictionary_ranks.h"
 #include <stdlib.h>
 #include <string.h>
 #include "furi.h"
+#include "storage/storage.h"
 
-// Dictionary entry structure
+#define TAG "DictionaryData"
+
+// Dictionary image locations. A dictionary copied to the app data folder
+// replaces the sample one bundled with the app.
+#define DICTIONARY_USER_PATH APP_DATA_PATH("dictionary.dict")
+#define DICTIONARY_ASSET_PATH APP_ASSETS_PATH("dictionary.dict")
+
+// Number of decoded word blocks kept in memory. Two cover any run of visible
+// rows, so the words of a list being drawn stay valid together; the prefetch
+// budget adds more for the blocks read ahead.
+#define DICTIONARY_WORD_CACHE_SLOTS (2 + DICTIONARY_WORD_PREFETCH_SLOTS)
+
+// Number of decompressed text blocks kept in memory
+#define DICTIONARY_TEXT_CACHE_SLOTS (4 + DICTIONARY_TEXT_PREFETCH_SLOTS)
+
+// Slots bought by DICTIONARY_DATA_PREFETCH_BUDGET: up to half of it goes to
+// word blocks, the rest to text blocks
+#define DICTIONARY_WORD_PREFETCH_SLOTS (DICTIONARY_DATA_PREFETCH_BUDGET / 2 / sizeof(DictionaryWordSlot))
+#define DICTIONARY_TEXT_PREFETCH_SLOTS                                                               \
+    ((DICTIONARY_DATA_PREFETCH_BUDGET - DICTIONARY_WORD_PREFETCH_SLOTS * sizeof(DictionaryWordSlot)) / \
+     DICTIONARY_TEXT_BLOCK_SIZE)
+
+// Entries between the scroll position and the word read ahead of it. Half a
+// block loads the next block well before its first row comes into view.
+#define DICTIONARY_DATA_PREFETCH_AHEAD (DICTIONARY_WORD_BLOCK_ENTRIES / 2)
+
+// First letter of the Russian alphabet, а
+#define DICTIONARY_DATA_CYRILLIC_A 0x430
+
+// Translation ranges this short are read through once for the letters that
+// continue them, rather than searched letter by letter
+#define DICTIONARY_DATA_REVERSE_SCAN_MAX 16
+
+// A decoded word block
 typedef struct {
-    const char* word;
-    const char* definition;
-    const char* translation;  // Add translation field for bilingual dictionaries
-} DictionaryEntry;
-
-// Dictionary data
-// This is a sample English-Russian dictionary.
-// In a real implementation, this would need to be stored in the Flipper Zero storage
-// or compressed in some way to fit more words.
-static const DictionaryEntry dictionary_entries[] = {
-    {"aardvark", "A large, nocturnal, burrowing mammal native to Africa.", "Трубкозуб"},
-    {"abacus", "A calculating device consisting of beads on wires.", "Счёты"},
-    {"abandon", "To leave completely and finally; forsake utterly; desert.", "Покидать"},
-    {"ability", "Capacity to do or act physically, mentally, legally, morally.", "Способность"},
-    {"abode", "A place in which one lives; residence; dwelling; home.", "Жилище"},
-    {"book", "A written or printed work consisting of pages.", "Книга"},
-    {"cat", "A small domesticated carnivorous mammal with soft fur.", "Кошка"},
-    {"dog", "A domesticated carnivorous mammal that typically has a long snout and tail.", "Собака"},
-    {"elephant", "A very large plant-eating mammal with a trunk and tusks.", "Слон"},
-    {"flower", "The seed-bearing part of a plant, consisting of reproductive organs.", "Цветок"},
-    {"guitar", "A stringed musical instrument with a fretted fingerboard.", "Гитара"},
-    {"house", "A building used as a home.", "Дом"},
-    {"internet", "A global computer network providing information and communication.", "Интернет"},
-    {"jungle", "An area of land overgrown with dense forest and vegetation.", "Джунгли"},
-    {"kangaroo", "A large hopping Australian marsupial with a long tail.", "Кенгуру"},
-    {"language", "The method of human communication, using words.", "Язык"},
-    {"music", "Vocal or instrumental sounds combined in a way that produces harmony.", "Музыка"},
-    {"notebook", "A small book with blank or ruled pages for writing notes.", "Блокнот"},
-    {"orange", "A round juicy citrus fruit with a tough bright reddish-yellow skin.", "Апельсин"},
-    {"piano", "A large musical instrument with a keyboard of black and white keys.", "Пианино"},
-    {"quiz", "A test of knowledge, especially as a competition.", "Викторина"},
-    {"river", "A large natural stream of water flowing in a channel to the sea or a lake.", "Река"},
-    {"sun", "The star around which the earth orbits.", "Солнце"},
-    {"table", "A piece of furniture with a flat top and one or more legs.", "Стол"},
-    {"umbrella", "A folding canopy supported by metal ribs, used as protection against rain.", "Зонт"},
-    {"violin", "A stringed musical instrument of treble pitch, played with a bow.", "Скрипка"},
-    {"watch", "A small timepiece worn typically on a strap on one's wrist.", "Часы"},
-    {"xylophone", "A musical instrument with wooden bars of different lengths.", "Ксилофон"},
-    {"yellow", "Of the color between green and orange in the spectrum.", "Жёлтый"},
-    {"zebra", "An African wild horse with black-and-white stripes.", "Зебра"},
-};
-
-// Number of entries in the dictionary
-static const uint32_t dictionary_entry_count = sizeof(dictionary_entries) / sizeof(DictionaryEntry);
+    uint32_t block;     // Block number, UINT32_MAX if the slot is unused
+    uint32_t last_used; // Access tick for least-recently-used replacement
+    bool prefetched;    // Read ahead and not requested since
+    char words[DICTIONARY_WORD_BLOCK_ENTRIES][DICTIONARY_WORD_MAX + 1];
+} DictionaryWordSlot;
+
+// A decompressed text block
+typedef struct {
+    uint32_t first_entry; // First entry in the block
+    uint32_t end_entry;   // One past the last entry, 0 if the slot is unused
+    uint32_t last_used;   // Access tick for least-recently-used replacement
+    bool prefetched;      // Read ahead and not requested since
+    char* data;           // "definition\0translation\0" for each entry
+} DictionaryTextSlot;
+
+// Open dictionary image
+static Storage* storage = NULL;
+static DictionaryFile* dictionary_file = NULL;
+static uint32_t entry_count = 0;
+static uint32_t word_index_base = 0;
+static uint32_t word_block_count = 0;
+static uint32_t word_data_base = 0;
+static uint32_t text_index_base = 0;
+static uint32_t text_block_count = 0;
+static uint32_t text_data_base = 0;
+static DictionaryCodec* codec = NULL;
+static DictionaryDawg* dawg = NULL;
+static uint32_t reverse_base = 0;
+static uint32_t reverse_count = 0;
+static bool reverse_root_known = false; // The letters of the empty prefix below are found
+static uint32_t reverse_root_letters = 0;
+static uint32_t reverse_root_starts[DICTIONARY_DATA_RUSSIAN_LETTERS + 1];
+static uint32_t letters_base = 0;
+static uint32_t bigrams_base = 0;
+static uint32_t bigram_row_count = 0;
+static DictionaryFulltext* fulltext = NULL;
+static DictionaryRanks* ranks = NULL;
+
+// Word block cache and search buffers
+static DictionaryWordSlot word_slots[DICTIONARY_WORD_CACHE_SLOTS];
+static uint32_t word_tick = 0;
+static char probe_buffer[DICTIONARY_WORD_MAX + 1];
+static char key_buffer[DICTIONARY_WORD_MAX + 1];
+static uint8_t word_block_buffer[DICTIONARY_WORD_BLOCK_SIZE];
+static char fold_key_buffer[DICTIONARY_FOLD_KEY_MAX + 1];
+static char fold_query_buffer[DICTIONARY_FOLD_KEY_MAX + 1];
+
+// Text block cache
+static DictionaryTextSlot text_slots[DICTIONARY_TEXT_CACHE_SLOTS];
+static uint32_t text_tick = 0;
+static uint8_t* packed_buffer = NULL;
+static DictionaryDataStats stats;
+
+// Read the offset of a word block in the word data section
+static bool dictionary_data_read_word_block_offset(uint32_t block, uint32_t* offset) {
+    return dictionary_file_read(
+        dictionary_file, word_index_base + block * sizeof(uint32_t), offset, sizeof(uint32_t));
+}
+
+// Read the first word of a block, which is stored whole, into the probe buffer
+static const char* dictionary_data_probe_block(uint32_t block) {
+    uint32_t offset;
+    probe_buffer[0] = '\0';
+    if(dictionary_data_read_word_block_offset(block, &offset)) {
+        dictionary_file_read_string(dictionary_file, word_data_base + offset, probe_buffer, sizeof(probe_buffer));
+    }
+    return probe_buffer;
+}
+
+// Find a decoded word block in the cache
+static DictionaryWordSlot* dictionary_data_find_word_block(uint32_t block) {
+    for(uint32_t i = 0; i < DICTIONARY_WORD_CACHE_SLOTS; i++) {
+        if(word_slots[i].block == block) return &word_slots[i];
+    }
+    return NULL;
+}
+
+// Decode a word block over the least recently used slot
+static DictionaryWordSlot* dictionary_data_load_word_block(uint32_t block) {
+    DictionaryWordSlot* slot = &word_slots[0];
+    for(uint32_t i = 1; i < DICTIONARY_WORD_CACHE_SLOTS; i++) {
+        if(word_slots[i].last_used < slot->last_used) {
+            slot = &word_slots[i];
+        }
+    }
+
+    uint32_t start, end;
+    if(!dictionary_data_read_word_block_offset(block, &start) ||
+       !dictionary_data_read_word_block_offset(block + 1, &end) || end <= start ||
+       end - start > DICTIONARY_WORD_BLOCK_SIZE ||
+       !dictionary_file_read(dictionary_file, word_data_base + start, word_block_buffer, end - start)) {
+        return NULL;
+    }
+
+    uint32_t first = block * DICTIONARY_WORD_BLOCK_ENTRIES;
+    uint32_t count = entry_count - first;
+    if(count > DICTIONARY_WORD_BLOCK_ENTRIES) {
+        count = DICTIONARY_WORD_BLOCK_ENTRIES;
+    }
+
+    // Undo the front coding: each word reuses the start of the one before it
+    const uint8_t* data = word_block_buffer;
+    const uint8_t* data_end = word_block_buffer + (end - start);
+    size_t previous_length = 0;
+    slot->block = UINT32_MAX;
+    for(uint32_t i = 0; i < count; i++) {
+        size_t length = 0;
+        if(i > 0) {
+            if(data == data_end || *data > previous_length) return NULL;
+            length = *data++;
+            memcpy(slot->words[i], slot->words[i - 1], length);
+        }
+        while(data < data_end && *data != '\0' && length < DICTIONARY_WORD_MAX) {
+            slot->words[i][length++] = *data++;
+        }
+        if(data == data_end || *data != '\0') return NULL;
+        data++;
+        slot->words[i][length] = '\0';
+        previous_length = length;
+    }
+
+    slot->block = block;
+    slot->last_used = word_tick;
+    slot->prefetched = false;
+    return slot;
+}
+
+// Get a decoded word block, decoding it on a miss. Only blocks of words
+// about to be shown count toward the prefetch hits and misses, the probes of
+// a search are not what reading ahead is for.
+static DictionaryWordSlot* dictionary_data_get_word_block(uint32_t block, bool shown) {
+    word_tick++;
+
+    DICTIONARY_PROFILE_COUNT(word_lookups, 1);
+    DictionaryWordSlot* slot = dictionary_data_find_word_block(block);
+    if(slot == NULL) {
+        slot = dictionary_data_load_word_block(block);
+        if(slot == NULL) return NULL;
+        if(shown) {
+            stats.prefetch_misses++;
+        }
+    } else {
+        DICTIONARY_PROFILE_COUNT(word_hits, 1);
+        if(shown && slot->prefetched) {
+            slot->prefetched = false;
+            stats.prefetch_hits++;
+        }
+    }
+    slot->last_used = word_tick;
+    return slot;
+}
+
+// Get a word from the word block cache, shown as for dictionary_data_get_word_block()
+static const char* dictionary_data_word_at(uint32_t index, bool shown) {
+    DictionaryWordSlot* slot = dictionary_data_get_word_block(index / DICTIONARY_WORD_BLOCK_ENTRIES, shown);
+    if(slot == NULL) return NULL;
+    return slot->words[index % DICTIONARY_WORD_BLOCK_ENTRIES];
+}
+
+// Find the first entry from the given one on whose word is not less than the
+// given word. All words in front of that entry must be less than it.
+static uint32_t dictionary_data_lower_bound(const char* word, uint32_t from) {
+    if(from >= entry_count) return entry_count;
+
+    // Callers may pass a word from the cache, which the search can evict
+    strncpy(key_buffer, word, sizeof(key_buffer) - 1);
+    key_buffer[sizeof(key_buffer) - 1] = '\0';
+
+    // Letter buckets: only the words sharing the first byte need searching
+    uint32_t end = entry_count;
+    uint32_t bucket[2];
+    if(key_buffer[0] != '\0' &&
+       dictionary_file_read(
+           dictionary_file, letters_base + (uint8_t)key_buffer[0] * sizeof(uint32_t), bucket, sizeof(bucket)) &&
+       bucket[0] <= bucket[1] && bucket[1] <= entry_count) {
+        if(from < bucket[0]) {
+            from = bucket[0];
+        }
+        end = bucket[1];
+        if(from >= end) return from;
+    }
+
+    // Sparse index: count the blocks whose first word is below the key
+    uint32_t low = from / DICTIONARY_WORD_BLOCK_ENTRIES;
+    uint32_t high = (end + DICTIONARY_WORD_BLOCK_ENTRIES - 1) / DICTIONARY_WORD_BLOCK_ENTRIES;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if(strcmp(dictionary_data_probe_block(mid), key_buffer) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if(low == 0) return from;
+
+    // The answer is inside the last of those blocks or starts the next one
+    uint32_t block = low - 1;
+    uint32_t first = block * DICTIONARY_WORD_BLOCK_ENTRIES;
+    if(first + DICTIONARY_WORD_BLOCK_ENTRIES <= from) return from;
+    DictionaryWordSlot* slot = dictionary_data_get_word_block(block, false);
+    if(slot == NULL) return first > from ? first : from;
+    uint32_t index = first + 1 > from ? first + 1 : from;
+    while(index < entry_count && index < first + DICTIONARY_WORD_BLOCK_ENTRIES &&
+          strcmp(slot->words[index - first], key_buffer) < 0) {
+        index++;
+    }
+    return index;
+}
+
+// Find the first entry from the given one on whose word does not start with the prefix
+static uint32_t dictionary_data_prefix_end(const char* prefix, uint32_t from) {
+    // Every word with the prefix sorts before the prefix with its last byte
+    // incremented; trailing 0xff bytes cannot be incremented and are dropped
+    char successor[DICTIONARY_WORD_MAX + 1];
+    size_t length = strlen(prefix);
+    if(length > DICTIONARY_WORD_MAX) {
+        length = DICTIONARY_WORD_MAX;
+    }
+    memcpy(successor, prefix, length);
+    while(length > 0 && (uint8_t)successor[length - 1] == 0xff) {
+        length--;
+    }
+    if(length == 0) return entry_count;
+
+    successor[length - 1]++;
+    successor[length] = '\0';
+    return dictionary_data_lower_bound(successor, from);
+}
+
+// Find the entry holding exactly the given word, or -1
+static int32_t dictionary_data_find_entry(const char* word) {
+    if(word == NULL || entry_count == 0) return -1;
+
+    uint32_t index = dictionary_data_lower_bound(word, 0);
+    const char* found = index < entry_count ? dictionary_data_word_at(index, false) : NULL;
+    if(found != NULL && strcmp(found, key_buffer) == 0) {
+        return index;
+    }
+    return -1;
+}
+
+// Read a record of the text index
+static bool dictionary_data_read_text_block(uint32_t block, DictionaryFileTextBlock* record) {
+    return dictionary_file_read(
+        dictionary_file,
+        text_index_base + block * sizeof(DictionaryFileTextBlock),
+        record,
+        sizeof(DictionaryFileTextBlock));
+}
+
+// Decompress the text block holding an entry into the least recently used slot
+static DictionaryTextSlot* dictionary_data_load_text_block(uint32_t index) {
+    // Find the last block starting at or before the entry
+    uint32_t low = 0;
+    uint32_t high = text_block_count;
+    DictionaryFileTextBlock record;
+    while(high - low > 1) {
+        uint32_t mid = low + (high - low) / 2;
+        if(!dictionary_data_read_text_block(mid, &record)) return NULL;
+        if(record.first_entry <= index) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    DictionaryFileTextBlock start, end;
+    if(!dictionary_data_read_text_block(low, &start) || !dictionary_data_read_text_block(low + 1, &end) ||
+       end.offset < start.offset || end.offset - start.offset > dictionary_codec_get_max_packed_size(codec) ||
+       end.first_entry <= start.first_entry) {
+        return NULL;
+    }
+
+    size_t packed_size = end.offset - start.offset;
+    if(!dictionary_file_read(dictionary_file, text_data_base + start.offset, packed_buffer, packed_size)) {
+        return NULL;
+    }
+
+    DictionaryTextSlot* slot = &text_slots[0];
+    for(uint32_t i = 1; i < DICTIONARY_TEXT_CACHE_SLOTS; i++) {
+        if(text_slots[i].last_used < slot->last_used) {
+            slot = &text_slots[i];
+        }
+    }
+
+    uint32_t strings = (end.first_entry - start.first_entry) * 2;
+    size_t decoded = dictionary_codec_decode(
+        codec, packed_buffer, packed_size, slot->data, DICTIONARY_TEXT_BLOCK_SIZE, strings);
+    if(decoded == 0) {
+        FURI_LOG_E(TAG, "Corrupt text block %lu", (unsigned long)low);
+        slot->end_entry = 0;
+        slot->last_used = 0;
+        return NULL;
+    }
+
+    stats.blocks_decoded++;
+    stats.bytes_decoded += decoded;
+    slot->first_entry = start.first_entry;
+    slot->end_entry = end.first_entry;
+    slot->prefetched = false;
+    return slot;
+}
+
+// Find the decompressed text block holding an entry in the cache
+static DictionaryTextSlot* dictionary_data_find_text_block(uint32_t index) {
+    for(uint32_t i = 0; i < DICTIONARY_TEXT_CACHE_SLOTS; i++) {
+        if(index >= text_slots[i].first_entry && index < text_slots[i].end_entry) return &text_slots[i];
+    }
+    return NULL;
+}
+
+// Get the definition or the translation of an entry from the text block
+// cache. As for words, only texts about to be shown count toward the
+// prefetch hits and misses.
+static const char* dictionary_data_get_text(uint32_t index, bool translation, bool shown) {
+    if(index >= entry_count || codec == NULL) return NULL;
+
+    stats.text_lookups++;
+    text_tick++;
+
+    DictionaryTextSlot* slot = dictionary_data_find_text_block(index);
+    if(slot == NULL) {
+        slot = dictionary_data_load_text_block(index);
+        if(slot == NULL) return NULL;
+        if(shown) {
+            stats.prefetch_misses++;
+        }
+    } else {
+        stats.text_cache_hits++;
+        if(shown && slot->prefetched) {
+            slot->prefetched = false;
+            stats.prefetch_hits++;
+        }
+    }
+    slot->last_used = text_tick;
+
+    // Skip the strings of the entries in front of this one
+    const char* text = slot->data;
+    uint32_t skip = (index - slot->first_entry) * 2 + (translation ? 1 : 0);
+    for(uint32_t i = 0; i < skip; i++) {
+        text += strlen(text) + 1;
+    }
+    return text;
+}
+
+// Read a record of the reverse index
+static bool dictionary_data_read_reverse(uint32_t position, DictionaryFileReverseRecord* record) {
+    return dictionary_file_read(
+        dictionary_file,
+        reverse_base + position * sizeof(DictionaryFileReverseRecord),
+        record,
+        sizeof(DictionaryFileReverseRecord));
+}
+
+// Fold the translation alternative a reverse index record points at
+static const char* dictionary_data_reverse_key(uint32_t position) {
+    DictionaryFileReverseRecord record;
+    fold_key_buffer[0] = '\0';
+    if(dictionary_data_read_reverse(position, &record)) {
+        const char* translation = dictionary_data_get_text(record.entry, true, false);
+        if(translation != NULL && record.offset <= strlen(translation)) {
+            dictionary_fold_key(translation + record.offset, fold_key_buffer);
+        }
+    }
+    return fold_key_buffer;
+}
+
+// Find the first reverse index position in [low, high) whose key is not less
+// than the folded query, or with prefix set, the first whose key doesn't
+// start with it
+static uint32_t dictionary_data_reverse_bound(uint32_t low, uint32_t high, bool prefix) {
+    size_t length = strlen(fold_query_buffer);
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        const char* key = dictionary_data_reverse_key(mid);
+        int result = prefix ? strncmp(key, fold_query_buffer, length) : strcmp(key, fold_query_buffer);
+        if(result < 0 || (prefix && result == 0)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Build the text decoder from the codec section
+static bool dictionary_data_load_codec(uint32_t offset, uint32_t size) {
+    uint8_t* section = malloc(size);
+    bool ok = dictionary_file_read(dictionary_file, offset, section, size);
+    if(ok) {
+        codec = dictionary_codec_alloc(section, size);
+        ok = codec != NULL;
+    }
+    free(section);
+    return ok;
+}
+
+// Read the header and section table, leaving the entries on storage
+static bool dictionary_data_load_header(const char* path) {
+    DictionaryFileHeader header;
+    if(!dictionary_file_read(dictionary_file, 0, &header, sizeof(header)) ||
+       header.magic != DICTIONARY_FILE_MAGIC) {
+        FURI_LOG_E(TAG, "%s is not a dictionary", path);
+        return false;
+    }
+    if(header.version != DICTIONARY_FILE_VERSION) {
+        FURI_LOG_E(TAG, "%s has unsupported version %u", path, header.version);
+        return false;
+    }
+    // Lookups rely on binary search, the compiler guarantees the order
+    if(!(header.flags & DICTIONARY_FILE_FLAG_SORTED)) {
+        FURI_LOG_E(TAG, "%s is not sorted", path);
+        return false;
+    }
+
+    uint32_t word_index_size = 0;
+    uint32_t word_data_size = 0;
+    uint32_t text_index_size = 0;
+    uint32_t reverse_size = 0;
+    uint32_t letters_size = 0;
+    uint32_t bigrams_size = 0;
+    DictionaryFileSection codec_section = {0};
+    DictionaryFileSection dawg_section = {0};
+    DictionaryFileSection terms_section = {0};
+    DictionaryFileSection term_strings_section = {0};
+    DictionaryFileSection postings_section = {0};
+    DictionaryFileSection ranks_section = {0};
+    for(uint16_t i = 0; i < header.section_count; i++) {
+        DictionaryFileSection section;
+        uint32_t offset = sizeof(header) + i * sizeof(section);
+        if(!dictionary_file_read(dictionary_file, offset, &section, sizeof(section)) ||
+           section.offset > dictionary_file_get_size(dictionary_file) ||
+           section.size > dictionary_file_get_size(dictionary_file) - section.offset) {
+            FURI_LOG_E(TAG, "%s has a broken section table", path);
+            return false;
+        }
+
+        if(section.id == DictionarySectionWordIndex) {
+            word_index_base = section.offset;
+            word_index_size = section.size;
+        } else if(section.id == DictionarySectionWordData) {
+            word_data_base = section.offset;
+            word_data_size = section.size;
+        } else if(section.id == DictionarySectionCodec) {
+            codec_section = section;
+        } else if(section.id == DictionarySectionTextIndex) {
+            text_index_base = section.offset;
+            text_index_size = section.size;
+        } else if(section.id == DictionarySectionTextData) {
+            text_data_base = section.offset;
+        } else if(section.id == DictionarySectionDawg) {
+            dawg_section = section;
+        } else if(section.id == DictionarySectionReverse) {
+            reverse_base = section.offset;
+            reverse_size = section.size;
+        } else if(section.id == DictionarySectionTerms) {
+            terms_section = section;
+        } else if(section.id == DictionarySectionTermStrings) {
+            term_strings_section = section;
+        } else if(section.id == DictionarySectionPostings) {
+            postings_section = section;
+        } else if(section.id == DictionarySectionLetters) {
+            letters_base = section.offset;
+            letters_size = section.size;
+        } else if(section.id == DictionarySectionRanks) {
+            ranks_section = section;
+        } else if(section.id == DictionarySectionBigrams) {
+            bigrams_base = section.offset;
+            bigrams_size = section.size;
+        }
+    }
+
+    word_block_count = (header.entry_count + DICTIONARY_WORD_BLOCK_ENTRIES - 1) / DICTIONARY_WORD_BLOCK_ENTRIES;
+    if(word_index_size != (word_block_count + 1) * sizeof(uint32_t) ||
+       text_index_size < sizeof(DictionaryFileTextBlock) ||
+       reverse_size % sizeof(DictionaryFileReverseRecord) != 0 || terms_section.size == 0 ||
+       letters_size != DICTIONARY_LETTER_COUNT * sizeof(uint32_t) ||
+       bigrams_size < DICTIONARY_BIGRAM_ROWS * sizeof(uint16_t) ||
+       (bigrams_size - DICTIONARY_BIGRAM_ROWS * sizeof(uint16_t)) % (DICTIONARY_BIGRAM_COLUMNS * sizeof(uint32_t)) !=
+           0 ||
+       (header.entry_count > 0 && (word_data_size == 0 || codec_section.size == 0 || dawg_section.size == 0))) {
+        FURI_LOG_E(TAG, "%s is missing sections", path);
+        return false;
+    }
+    text_block_count = text_index_size / sizeof(DictionaryFileTextBlock) - 1;
+    bigram_row_count = (bigrams_size - DICTIONARY_BIGRAM_ROWS * sizeof(uint16_t)) /
+                       (DICTIONARY_BIGRAM_COLUMNS * sizeof(uint32_t));
+    reverse_count = reverse_size / sizeof(DictionaryFileReverseRecord);
+    reverse_root_known = false;
+
+    if(header.entry_count > 0 && !dictionary_data_load_codec(codec_section.offset, codec_section.size)) {
+        FURI_LOG_E(TAG, "%s has a broken codec", path);
+        return false;
+    }
+    if(header.entry_count > 0) {
+        dawg = dictionary_dawg_alloc(dictionary_file, dawg_section.offset, dawg_section.size);
+        if(dawg == NULL) {
+            FURI_LOG_E(TAG, "%s has a broken prefix index", path);
+            return false;
+        }
+        uint32_t dawg_size = dictionary_dawg_get_size(dawg);
+        FURI_LOG_I(
+            TAG,
+            "Prefix index: %lu nodes, %lu bytes (%lu.%02lu bytes/word)",
+            (unsigned long)dictionary_dawg_get_node_count(dawg),
+            (unsigned long)dawg_size,
+            (unsigned long)(dawg_size / header.entry_count),
+            (unsigned long)(dawg_size % header.entry_count * 100 / header.entry_count));
+    }
+
+    fulltext = dictionary_fulltext_alloc(
+        dictionary_file,
+        header.entry_count,
+        terms_section.offset,
+        terms_section.size,
+        term_strings_section.offset,
+        term_strings_section.size,
+        postings_section.offset,
+        postings_section.size);
+    if(fulltext == NULL) {
+        FURI_LOG_E(TAG, "%s has a broken full-text index", path);
+        return false;
+    }
+    FURI_LOG_I(
+        TAG,
+        "Full-text index: %lu words, %lu bytes",
+        (unsigned long)dictionary_fulltext_get_term_count(fulltext),
+        (unsigned long)dictionary_fulltext_get_size(fulltext));
+
+    ranks = dictionary_ranks_alloc(dictionary_file, header.entry_count, ranks_section.offset, ranks_section.size);
+    if(ranks == NULL) {
+        FURI_LOG_E(TAG, "%s has broken frequency ranks", path);
+        return false;
+    }
+
+    entry_count = header.entry_count;
+    FURI_LOG_I(TAG, "Loaded %lu words from %s", (unsigned long)entry_count, path);
+    return true;
+}
+
+// Open a dictionary image, returns false if it is missing or invalid
+static bool dictionary_data_open(const char* path) {
+    dictionary_file = dictionary_file_open(storage, path);
+    if(dictionary_file == NULL) {
+        return false;
+    }
+
+    if(!dictionary_data_load_header(path)) {
+        dictionary_ranks_free(ranks);
+        ranks = NULL;
+        dictionary_fulltext_free(fulltext);
+        fulltext = NULL;
+        dictionary_dawg_free(dawg);
+        dawg = NULL;
+        dictionary_codec_free(codec);
+        codec = NULL;
+        dictionary_file_close(dictionary_file);
+        dictionary_file = NULL;
+        entry_count = 0;
+        reverse_count = 0;
+        reverse_root_known = false;
+        return false;
+    }
+    return true;
+}
 
 // Initialize dictionary data
 void dictionary_data_init(void) {
-    // No initialization needed for static data
-    // In a real implementation, this would load data from storage
+    storage = furi_record_open(RECORD_STORAGE);
+
+    entry_count = 0;
+    if(!dictionary_data_open(DICTIONARY_USER_PATH)) {
+        // An empty dictionary is reported by the UI
+        dictionary_data_open(DICTIONARY_ASSET_PATH);
+    }
+
+    for(uint32_t i = 0; i < DICTIONARY_WORD_CACHE_SLOTS; i++) {
+        word_slots[i].block = UINT32_MAX;
+        word_slots[i].last_used = 0;
+        word_slots[i].prefetched = false;
+    }
+    word_tick = 0;
+    text_tick = 0;
+    memset(&stats, 0, sizeof(stats));
+    if(codec != NULL) {
+        packed_buffer = malloc(dictionary_codec_get_max_packed_size(codec));
+        for(uint32_t i = 0; i < DICTIONARY_TEXT_CACHE_SLOTS; i++) {
+            text_slots[i].first_entry = 0;
+            text_slots[i].end_entry = 0;
+            text_slots[i].last_used = 0;
+            text_slots[i].prefetched = false;
+            text_slots[i].data = malloc(DICTIONARY_TEXT_BLOCK_SIZE);
+        }
+    }
 }
 
 // Free dictionary data
 void dictionary_data_free(void) {
-    // No cleanup needed for static data
-    // In a real implementation, this would free allocated memory
+    if(codec != NULL) {
+        for(uint32_t i = 0; i < DICTIONARY_TEXT_CACHE_SLOTS; i++) {
+            free(text_slots[i].data);
+            text_slots[i].data = NULL;
+        }
+        free(packed_buffer);
+        packed_buffer = NULL;
+        dictionary_codec_free(codec);
+        codec = NULL;
+    }
+
+    dictionary_ranks_free(ranks);
+    ranks = NULL;
+    dictionary_fulltext_free(fulltext);
+    fulltext = NULL;
+    dictionary_dawg_free(dawg);
+    dawg = NULL;
+    dictionary_file_close(dictionary_file);
+    dictionary_file = NULL;
+    entry_count = 0;
+    reverse_count = 0;
+    reverse_root_known = false;
+
+    furi_record_close(RECORD_STORAGE);
+    storage = NULL;
 }
 
 // Get the number of words in the dictionary
 uint32_t dictionary_data_get_word_count(void) {
-    return dictionary_entry_count;
+    return entry_count;
 }
 
 // Get a word at a specific index
 const char* dictionary_data_get_word(uint32_t index) {
-    if(index < dictionary_entry_count) {
-        return dictionary_entries[index].word;
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileWord);
+    if(index >= entry_count) {
+        return NULL;
+    }
+
+    const char* word = dictionary_data_word_at(index, true);
+    return word != NULL ? word : "";
+}
+
+// Copy the words at a batch of indices
+void dictionary_data_get_words(const uint32_t* indices, uint32_t count, char (*words)[DICTIONARY_WORD_MAX + 1]) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileWord);
+    for(uint32_t i = 0; i < count; i++) {
+        words[i][0] = '\0';
+    }
+
+    // Each block is decoded once for all the indices in it, in any order
+    for(uint32_t i = 0; i < count; i++) {
+        if(words[i][0] != '\0' || indices[i] >= entry_count) continue;
+        uint32_t block = indices[i] / DICTIONARY_WORD_BLOCK_ENTRIES;
+        DictionaryWordSlot* slot = dictionary_data_get_word_block(block, true);
+        if(slot == NULL) continue;
+        for(uint32_t j = i; j < count; j++) {
+            if(indices[j] < entry_count && indices[j] / DICTIONARY_WORD_BLOCK_ENTRIES == block) {
+                strcpy(words[j], slot->words[indices[j] % DICTIONARY_WORD_BLOCK_ENTRIES]);
+            }
+        }
     }
-    return NULL;
 }
 
 // Get the definition for a word
 const char* dictionary_data_get_definition(const char* word) {
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strcmp(dictionary_entries[i].word, word) == 0) {
-            return dictionary_entries[i].definition;
-        }
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileLookup);
+    int32_t index = dictionary_data_find_entry(word);
+    const char* definition = index >= 0 ? dictionary_data_get_text(index, false, false) : NULL;
+    if(definition != NULL) {
+        return definition;
     }
-    
+
     // Word not found
     return "Definition not found";
 }
 
+// Get the definition of the word at an index
+const char* dictionary_data_get_definition_by_index(uint32_t index) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileText);
+    const char* definition = dictionary_data_get_text(index, false, true);
+    if(definition != NULL) {
+        return definition;
+    }
+    return "Definition not found";
+}
+
 // Check if a word exists in the dictionary
 bool dictionary_data_word_exists(const char* word) {
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strcmp(dictionary_entries[i].word, word) == 0) {
-            return true;
-        }
-    }
-    
-    return false;
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileLookup);
+    return dictionary_data_find_entry(word) >= 0;
 }
 
 // Find words starting with a prefix
 uint32_t dictionary_data_find_words_with_prefix(const char* prefix, uint32_t** indices) {
-    // Count matching words first
-    uint32_t count = 0;
-    uint32_t prefix_len = strlen(prefix);
-    
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strncmp(dictionary_entries[i].word, prefix, prefix_len) == 0) {
-            count++;
-        }
-    }
-    
+    uint32_t first, last;
+    uint32_t count = dictionary_data_find_prefix_range(prefix, &first, &last);
+
     // Allocate array for indices
     *indices = malloc(count * sizeof(uint32_t));
     if(*indices == NULL) {
         return 0;
     }
-    
-    // Fill array with indices
-    uint32_t index = 0;
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strncmp(dictionary_entries[i].word, prefix, prefix_len) == 0) {
-            (*indices)[index++] = i;
+
+    // The matches are consecutive entries
+    for(uint32_t i = 0; i < count; i++) {
+        (*indices)[i] = first + i;
+    }
+
+    return count;
+}
+
+// Find the range of words starting with a prefix
+uint32_t dictionary_data_find_prefix_range(const char* prefix, uint32_t* first, uint32_t* last) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfilePrefix);
+    *first = dictionary_data_lower_bound(prefix, 0);
+    *last = dictionary_data_prefix_end(prefix, *first);
+    return *last - *first;
+}
+
+// Start a prefix search that matches every word
+void dictionary_data_prefix_start(DictionaryPrefix* prefix) {
+    prefix->node = dawg != NULL ? dictionary_dawg_get_root(dawg) : 0;
+    prefix->first = 0;
+    prefix->last = entry_count;
+}
+
+// Narrow a prefix search by one more letter
+uint32_t dictionary_data_prefix_add(DictionaryPrefix* prefix, char letter) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfilePrefix);
+    if(prefix->first == prefix->last) return 0;
+
+    if(dawg == NULL ||
+       !dictionary_dawg_step(dawg, &prefix->node, &prefix->first, &prefix->last, (uint8_t)letter)) {
+        prefix->last = prefix->first;
+        return 0;
+    }
+    return prefix->last - prefix->first;
+}
+
+// Get the letters that continue a prefix search
+uint32_t dictionary_data_prefix_get_next_letters(const DictionaryPrefix* prefix) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfilePrefix);
+    if(dawg == NULL || prefix->first == prefix->last) return 0;
+
+    // The edges of the node are the letters, at most one per byte value
+    DictionaryDawgEdges edges;
+    DictionaryDawgEdge edge;
+    bool final;
+    uint32_t letters = 0;
+    if(!dictionary_dawg_edges_start(dawg, &edges, prefix->node, prefix->first, prefix->last, &final)) return 0;
+    while(dictionary_dawg_edges_next(dawg, &edges, &edge)) {
+        if(edge.label >= 'a' && edge.label <= 'z') {
+            letters |= 1u << (edge.label - 'a');
         }
     }
-    
+    return letters;
+}
+
+// Find the range of translations starting with a prefix
+uint32_t dictionary_data_find_translation_range(const char* prefix, uint32_t* first, uint32_t* last) {
+    DictionaryPrefix range;
+    dictionary_data_translation_start(&range);
+    uint32_t count = dictionary_data_translation_narrow(&range, prefix);
+    *first = range.first;
+    *last = range.last;
     return count;
 }
 
-// Find a word index by its string
-int32_t dictionary_data_find_word_index(const char* word) {
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strcmp(dictionary_entries[i].word, word) == 0) {
-            return i;
+// Start a translation search that matches every translation
+void dictionary_data_translation_start(DictionaryPrefix* range) {
+    range->node = 0;
+    range->first = 0;
+    range->last = reverse_count;
+}
+
+// Narrow a translation search to a longer prefix
+uint32_t dictionary_data_translation_narrow(DictionaryPrefix* range, const char* prefix) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileTranslation);
+    // The translations with the longer prefix are a run inside the range
+    dictionary_fold_key(prefix, fold_query_buffer);
+    range->first = dictionary_data_reverse_bound(range->first, range->last, false);
+    range->last = dictionary_data_reverse_bound(range->first, range->last, true);
+    return range->last - range->first;
+}
+
+// Get the letter a folded key goes on with after length bytes, as an offset
+// from а: -1 for anything sorting before а, DICTIONARY_DATA_RUSSIAN_LETTERS
+// for anything after я
+static int8_t dictionary_data_reverse_letter(const char* key, size_t length) {
+    const uint8_t* next = (const uint8_t*)key + length;
+    if(next[0] < 0xc0) return -1; // The end of the key or ASCII
+    if(next[0] >= 0xe0) return DICTIONARY_DATA_RUSSIAN_LETTERS;
+
+    uint16_t code = ((next[0] & 0x1f) << 6) | (next[1] & 0x3f);
+    if(code < DICTIONARY_DATA_CYRILLIC_A) return -1;
+    if(code >= DICTIONARY_DATA_CYRILLIC_A + DICTIONARY_DATA_RUSSIAN_LETTERS) return DICTIONARY_DATA_RUSSIAN_LETTERS;
+    return code - DICTIONARY_DATA_CYRILLIC_A;
+}
+
+// Get the letters that continue a translation search
+uint32_t dictionary_data_translation_get_next_letters(
+    const DictionaryPrefix* range,
+    const char* prefix,
+    uint32_t* starts) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileTranslation);
+    uint32_t own_starts[DICTIONARY_DATA_RUSSIAN_LETTERS + 1];
+    if(starts == NULL) {
+        starts = own_starts;
+    }
+    size_t length = dictionary_fold_key(prefix, fold_query_buffer);
+
+    // The letters of the whole index, searched most, are found only once
+    bool root = length == 0 && range->first == 0 && range->last == reverse_count;
+    if(root && reverse_root_known) {
+        memcpy(starts, reverse_root_starts, sizeof(reverse_root_starts));
+        return reverse_root_letters;
+    }
+    if(length + 2 > DICTIONARY_FOLD_KEY_MAX) {
+        for(uint8_t i = 0; i <= DICTIONARY_DATA_RUSSIAN_LETTERS; i++) {
+            starts[i] = range->last;
+        }
+        return 0;
+    }
+
+    // The keys sort by the letter they go on with, so each letter is a run
+    // that ends where the next letter present starts
+    uint32_t letters = 0;
+    uint8_t next = 0; // First letter whose start is not known yet
+    uint32_t position = range->first;
+    if(range->last - range->first <= DICTIONARY_DATA_REVERSE_SCAN_MAX) {
+        for(; position < range->last && next <= DICTIONARY_DATA_RUSSIAN_LETTERS; position++) {
+            int8_t letter = dictionary_data_reverse_letter(dictionary_data_reverse_key(position), length);
+            while(next <= letter) {
+                starts[next++] = position;
+            }
+            if(letter >= 0 && letter < DICTIONARY_DATA_RUSSIAN_LETTERS) {
+                letters |= 1u << letter;
+            }
+        }
+    } else {
+        // Jump from the start of one letter straight to the next letter
+        // present, one binary search within the range per letter
+        uint8_t* bytes = (uint8_t*)fold_query_buffer + length;
+        while(next <= DICTIONARY_DATA_RUSSIAN_LETTERS) {
+            uint16_t code = DICTIONARY_DATA_CYRILLIC_A + next;
+            bytes[0] = 0xc0 | (code >> 6);
+            bytes[1] = 0x80 | (code & 0x3f);
+            bytes[2] = '\0';
+            position = dictionary_data_reverse_bound(position, range->last, false);
+            if(position == range->last) break;
+
+            // The key sorts at or after the letter, unless the index is corrupt
+            int8_t letter = dictionary_data_reverse_letter(dictionary_data_reverse_key(position), length);
+            if(letter < next) break;
+            while(next <= letter) {
+                starts[next++] = position;
+            }
+            if(letter < DICTIONARY_DATA_RUSSIAN_LETTERS) {
+                letters |= 1u << letter;
+            }
         }
     }
-    
-    return -1;
+    while(next <= DICTIONARY_DATA_RUSSIAN_LETTERS) {
+        starts[next++] = range->last;
+    }
+    if(root) {
+        memcpy(reverse_root_starts, starts, sizeof(reverse_root_starts));
+        reverse_root_letters = letters;
+        reverse_root_known = true;
+    }
+    return letters;
+}
+
+// Get the entry of a translation in the reverse index
+uint32_t dictionary_data_get_translation_entry(uint32_t position) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileTranslation);
+    DictionaryFileReverseRecord record;
+    if(position >= reverse_count || !dictionary_data_read_reverse(position, &record) || record.entry >= entry_count) {
+        return 0;
+    }
+    return record.entry;
+}
+
+// Find words whose definition contains every word of a query
+uint32_t dictionary_data_find_words_with_definition(
+    const char* query,
+    uint32_t* indices,
+    uint32_t max_indices,
+    DictionaryDataProgress progress,
+    void* context) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileSearch);
+    return dictionary_fulltext_search(fulltext, query, indices, max_indices, progress, context);
+}
+
+// Find words within a few edits of a word
+uint32_t dictionary_data_find_similar_words(
+    const char* word,
+    uint8_t max_distance,
+    DictionaryMatch* matches,
+    uint32_t max_matches,
+    DictionaryDataProgress progress,
+    void* context) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileSearch);
+    return dictionary_fuzzy_search(dawg, entry_count, word, max_distance, matches, max_matches, progress, context);
+}
+
+// Find the most frequent words starting with a prefix
+uint32_t dictionary_data_find_top_words(
+    const DictionaryPrefix* prefix,
+    DictionaryRankedWord* words,
+    uint32_t max_words,
+    DictionaryDataProgress progress,
+    void* context) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileSearch);
+    return dictionary_ranks_find_top(ranks, prefix->first, prefix->last, words, max_words, progress, context);
+}
+
+// Find the bucket [*first, *last) of the words sharing the first letter of a
+// word, or its first two letters with bigrams set
+static bool dictionary_data_get_bucket(uint32_t index, bool bigrams, uint32_t* first, uint32_t* last) {
+    const char* word = dictionary_data_word_at(index, false);
+    if(word == NULL) return false;
+    uint8_t letter = word[0];
+
+    uint32_t bucket[2];
+    if(!dictionary_file_read(dictionary_file, letters_base + letter * sizeof(uint32_t), bucket, sizeof(bucket))) {
+        return false;
+    }
+    *first = bucket[0];
+    *last = bucket[1];
+
+    // The row splits the bucket further, runs before the word's end at or
+    // before it and the first one after it ends the word's run
+    if(bigrams) {
+        uint16_t row_number;
+        uint32_t row[DICTIONARY_BIGRAM_COLUMNS];
+        if(!dictionary_file_read(
+               dictionary_file, bigrams_base + letter * sizeof(row_number), &row_number, sizeof(row_number)) ||
+           row_number >= bigram_row_count ||
+           !dictionary_file_read(
+               dictionary_file,
+               bigrams_base + DICTIONARY_BIGRAM_ROWS * sizeof(row_number) + row_number * sizeof(row),
+               row,
+               sizeof(row))) {
+            return false;
+        }
+        for(uint8_t column = 0; column < DICTIONARY_BIGRAM_COLUMNS; column++) {
+            if(row[column] > index) {
+                if(row[column] < *last) {
+                    *last = row[column];
+                }
+                break;
+            }
+            if(row[column] > *first) {
+                *first = row[column];
+            }
+        }
+    }
+    return *first <= index && index < *last && *last <= entry_count;
+}
+
+// Find the first word of the bucket after the one holding a word
+uint32_t dictionary_data_get_next_bucket(uint32_t index, bool bigrams) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileJump);
+    if(index >= entry_count) return entry_count;
+
+    uint32_t first, last;
+    if(!dictionary_data_get_bucket(index, bigrams, &first, &last)) return index;
+    return last;
+}
+
+// Find the first word of the bucket holding a word, or of the one before
+uint32_t dictionary_data_get_previous_bucket(uint32_t index, bool bigrams) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileJump);
+    if(index == 0 || index > entry_count) return 0;
+
+    uint32_t first, last;
+    if(index < entry_count) {
+        if(!dictionary_data_get_bucket(index, bigrams, &first, &last)) return index;
+        if(first < index) return first;
+    }
+    if(!dictionary_data_get_bucket(index - 1, bigrams, &first, &last)) return index;
+    return first;
+}
+
+// Find a word index by its string
+int32_t dictionary_data_find_word_index(const char* word) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileLookup);
+    return dictionary_data_find_entry(word);
 }
 
 // Get the translation for a word (for bilingual dictionaries)
 const char* dictionary_data_get_translation(const char* word) {
-    for(uint32_t i = 0; i < dictionary_entry_count; i++) {
-        if(strcmp(dictionary_entries[i].word, word) == 0) {
-            return dictionary_entries[i].translation;
-        }
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileLookup);
+    int32_t index = dictionary_data_find_entry(word);
+    const char* translation = index >= 0 ? dictionary_data_get_text(index, true, false) : NULL;
+    if(translation != NULL) {
+        return translation;
     }
-    
+
     // Translation not found
     return "Translation not available";
 }
 
 // Get the translation for a word by its index
 const char* dictionary_data_get_translation_by_index(uint32_t index) {
-    if(index < dictionary_entry_count) {
-        return dictionary_entries[index].translation;
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileText);
+    const char* translation = dictionary_data_get_text(index, true, true);
+    if(translation != NULL) {
+        return translation;
     }
     return "Translation not available";
 }
+
+// Decode the text block holding an entry ahead of its use, unless it is cached
+static void dictionary_data_prefetch_text_block(uint32_t index) {
+    if(dictionary_data_find_text_block(index) != NULL) return;
+
+    DictionaryTextSlot* slot = dictionary_data_load_text_block(index);
+    if(slot == NULL) return;
+    slot->last_used = ++text_tick;
+    slot->prefetched = true;
+    stats.prefetch_reads++;
+}
+
+// Read ahead of a scroll position, within the prefetch budget
+void dictionary_data_prefetch(uint32_t index, bool forward) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfilePrefetch);
+    if(index >= entry_count) return;
+
+    if(DICTIONARY_WORD_PREFETCH_SLOTS > 0) {
+        uint32_t ahead;
+        if(forward) {
+            ahead = entry_count - 1 - index > DICTIONARY_DATA_PREFETCH_AHEAD ? index + DICTIONARY_DATA_PREFETCH_AHEAD :
+                                                                               entry_count - 1;
+        } else {
+            ahead = index > DICTIONARY_DATA_PREFETCH_AHEAD ? index - DICTIONARY_DATA_PREFETCH_AHEAD : 0;
+        }
+        uint32_t block = ahead / DICTIONARY_WORD_BLOCK_ENTRIES;
+        if(dictionary_data_find_word_block(block) == NULL) {
+            DictionaryWordSlot* slot = dictionary_data_load_word_block(block);
+            if(slot != NULL) {
+                slot->last_used = ++word_tick;
+                slot->prefetched = true;
+                stats.prefetch_reads++;
+            }
+        }
+    }
+
+    if(codec != NULL && DICTIONARY_TEXT_PREFETCH_SLOTS > 0) {
+        // The selected entry may be opened next, or its neighbour scrolled to
+        dictionary_data_prefetch_text_block(index);
+        if(forward && index + 1 < entry_count) {
+            dictionary_data_prefetch_text_block(index + 1);
+        } else if(!forward && index > 0) {
+            dictionary_data_prefetch_text_block(index - 1);
+        }
+    }
+}
+
+// Get the text block cache counters
+void dictionary_data_get_stats(DictionaryDataStats* out) {
+    *out = stats;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "dictionary_format.h"
+
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -15,15 +17,143 @@ uint32_t dictionary_data_get_word_count(void);
 // Get a word at a specific index
 const char* dictionary_data_get_word(uint32_t index);
 
+// Copy the words at count indices to words, decoding each word block once
+// for indices that share it. Words out of range come back empty.
+void dictionary_data_get_words(const uint32_t* indices, uint32_t count, char (*words)[DICTIONARY_WORD_MAX + 1]);
+
 // Get the definition for a word
 const char* dictionary_data_get_definition(const char* word);
 
+// Get the definition of the word at an index
+const char* dictionary_data_get_definition_by_index(uint32_t index);
+
 // Check if a word exists in the dictionary
 bool dictionary_data_word_exists(const char* word);
 
 // Find words starting with a prefix
 uint32_t dictionary_data_find_words_with_prefix(const char* prefix, uint32_t** indices);
 
+// Find the range [first, last) of words starting with a prefix, without
+// allocating. Returns the number of words in the range.
+uint32_t dictionary_data_find_prefix_range(const char* prefix, uint32_t* first, uint32_t* last);
+
+// Prefix search state: the DAWG node of the prefix and the range
+// [first, last) of the words starting with it
+typedef struct {
+    uint32_t node;
+    uint32_t first;
+    uint32_t last;
+} DictionaryPrefix;
+
+// Start a prefix search that matches every word
+void dictionary_data_prefix_start(DictionaryPrefix* prefix);
+
+// Narrow a prefix search by one more letter, one DAWG node per letter.
+// Returns the number of words still matching.
+uint32_t dictionary_data_prefix_add(DictionaryPrefix* prefix, char letter);
+
+// Get the letters that continue a prefix search: bit i is set if a word
+// starting with the prefix continues with 'a' + i
+uint32_t dictionary_data_prefix_get_next_letters(const DictionaryPrefix* prefix);
+
+// Find the range [first, last) of reverse index positions whose translation
+// starts with a prefix, ignoring case and the difference between ё and е.
+// A translation is indexed once per alternative (see dictionary_fold.h).
+// Returns the number of positions in the range.
+uint32_t dictionary_data_find_translation_range(const char* prefix, uint32_t* first, uint32_t* last);
+
+// Start a translation search that matches every translation. Translation
+// searches keep reverse index positions in first and last; node is unused.
+void dictionary_data_translation_start(DictionaryPrefix* range);
+
+// Narrow a translation search to a prefix. The range must be the result of
+// a search for a shorter prefix of it, so only the range is searched.
+// Returns the number of positions still matching.
+uint32_t dictionary_data_translation_narrow(DictionaryPrefix* range, const char* prefix);
+
+// Letters of the Russian alphabet offered after a translation prefix, а to я
+#define DICTIONARY_DATA_RUSSIAN_LETTERS 32
+
+// Get the letters that continue a translation search for a prefix: bit i
+// is set if a translation starting with it continues with U+0430 + i (а to
+// я; ё is folded to е). If starts is not NULL it receives
+// DICTIONARY_DATA_RUSSIAN_LETTERS + 1 positions, the translations going on
+// with letter i being [starts[i], starts[i + 1]), so narrowing the search to
+// any of the letters needs no further reads.
+uint32_t dictionary_data_translation_get_next_letters(
+    const DictionaryPrefix* range,
+    const char* prefix,
+    uint32_t* starts);
+
+// Get the word index of a position in the reverse index
+uint32_t dictionary_data_get_translation_entry(uint32_t position);
+
+// Progress of a query that can take long on a large dictionary, called
+// every DICTIONARY_DATA_PROGRESS_STEPS steps of it with the number of
+// results found so far. The results written so far are complete up to
+// then. Returning false stops the query, which returns what it has found.
+// Pass NULL to run a query to the end.
+typedef bool (*DictionaryDataProgress)(uint32_t found, void* context);
+
+#define DICTIONARY_DATA_PROGRESS_STEPS 64
+
+// A word close to a misspelled one
+typedef struct {
+    uint32_t index;
+    uint8_t distance; // Letters inserted, deleted or replaced to get from one to the other
+} DictionaryMatch;
+
+// Find the words whose definition contains every word of a query, ignoring
+// case and common words such as "the" (see dictionary_fold.h). Writes the
+// first max_indices word indices in alphabetical order and returns how many
+// words match in total.
+uint32_t dictionary_data_find_words_with_definition(
+    const char* query,
+    uint32_t* indices,
+    uint32_t max_indices,
+    DictionaryDataProgress progress,
+    void* context);
+
+// A word and its frequency rank, higher for more frequent words
+typedef struct {
+    uint32_t index;
+    uint8_t rank;
+} DictionaryRankedWord;
+
+// Find the max_words most frequent words starting with a prefix, most
+// frequent first and alphabetical within a rank. Only groups of words that
+// can still make the list are read, not the whole range. Returns the number
+// found.
+uint32_t dictionary_data_find_top_words(
+    const DictionaryPrefix* prefix,
+    DictionaryRankedWord* words,
+    uint32_t max_words,
+    DictionaryDataProgress progress,
+    void* context);
+
+// Find up to max_matches words within max_distance (at most 2) edits of a
+// word, closest first and alphabetical within a distance. Returns the
+// number found.
+uint32_t dictionary_data_find_similar_words(
+    const char* word,
+    uint8_t max_distance,
+    DictionaryMatch* matches,
+    uint32_t max_matches,
+    DictionaryDataProgress progress,
+    void* context);
+
+// Word list buckets: the words sharing their first letter, or with bigrams
+// set their first two letters. Both come from precomputed tables, so a jump
+// takes a few reads however many words it skips.
+
+// Find the first word of the bucket after the one holding a word. Returns
+// the number of words after the last bucket.
+uint32_t dictionary_data_get_next_bucket(uint32_t index, bool bigrams);
+
+// Find the first word of the bucket holding a word, or of the bucket before
+// if the word is its first one
+uint32_t dictionary_data_get_previous_bucket(uint32_t index, bool bigrams);
+
 // Find a word index by its string
 int32_t dictionary_data_find_word_index(const char* word);
 
@@ -32,3 +162,32 @@ const char* dictionary_data_get_translation(const char* word);
 
 // Get the translation for a word by its index
 const char* dictionary_data_get_translation_by_index(uint32_t index);
+
+// Memory in bytes that may hold word and text blocks read ahead of the
+// scroll position, on top of the caches for the entries shown. 0 turns
+// prefetching off.
+#ifndef DICTIONARY_DATA_PREFETCH_BUDGET
+#define DICTIONARY_DATA_PREFETCH_BUDGET 4096
+#endif
+
+// Read the blocks that scrolling from an entry in the given direction is
+// about to need: the words a few entries further on and the texts of the
+// entry and of its neighbour. Blocks already cached are not read again.
+void dictionary_data_prefetch(uint32_t index, bool forward);
+
+// Block cache counters, for profiling. The prefetch hits and misses count
+// only the fetches reading ahead serves: words by index, from
+// dictionary_data_get_word() and dictionary_data_get_words(), and texts by
+// index. Lookups by word and the probes of searches count neither.
+typedef struct {
+    uint32_t text_lookups;    // Definitions and translations requested
+    uint32_t text_cache_hits; // Requests served from an already decompressed block
+    uint32_t blocks_decoded;  // Text blocks decompressed, on a miss or ahead of use
+    uint32_t bytes_decoded;   // Bytes those blocks expanded to
+    uint32_t prefetch_reads;  // Word and text blocks read ahead of use
+    uint32_t prefetch_hits;   // Shown words and texts served first by a block read ahead
+    uint32_t prefetch_misses; // Blocks read only when a shown word or text needed them
+} DictionaryDataStats;
+
+// Get the block cache counters since dictionary_data_init()
+void dictionary_data_get_stats(DictionaryDataStats* stats);
@@ -0,0 +1,205 @@
+#include "dictionary_dawg.h"
+#include "dictionary_format.h"
+
+#include <stdlib.h>
+#include "furi.h"
+
+// Bytes read ahead while scanning the edges of a node
+#define DICTIONARY_DAWG_BUFFER_SIZE 64
+
+struct DictionaryDawg {
+    DictionaryFile* file;
+    uint32_t base; // Offset of the first node in the file
+    uint32_t size; // Size of the nodes
+    uint32_t root;
+    uint32_t section_size;
+    uint32_t node_count;
+
+    // Read-ahead buffer, buffer[0] is the byte at buffer_offset
+    uint8_t buffer[DICTIONARY_DAWG_BUFFER_SIZE];
+    uint32_t buffer_offset;
+    uint32_t buffer_length;
+};
+
+// Read the next byte of the nodes
+static bool dictionary_dawg_read_byte(DictionaryDawg* dawg, uint32_t* offset, uint8_t* byte) {
+    if(*offset >= dawg->size) return false;
+
+    if(*offset < dawg->buffer_offset || *offset >= dawg->buffer_offset + dawg->buffer_length) {
+        uint32_t length = dawg->size - *offset;
+        if(length > DICTIONARY_DAWG_BUFFER_SIZE) {
+            length = DICTIONARY_DAWG_BUFFER_SIZE;
+        }
+        if(!dictionary_file_read(dawg->file, dawg->base + *offset, dawg->buffer, length)) {
+            dawg->buffer_length = 0;
+            return false;
+        }
+        dawg->buffer_offset = *offset;
+        dawg->buffer_length = length;
+    }
+
+    *byte = dawg->buffer[*offset - dawg->buffer_offset];
+    (*offset)++;
+    return true;
+}
+
+// Read the next varint of the nodes
+static bool dictionary_dawg_read_varint(DictionaryDawg* dawg, uint32_t* offset, uint32_t* value) {
+    *value = 0;
+    for(uint8_t shift = 0; shift < 32; shift += 7) {
+        uint8_t byte;
+        if(!dictionary_dawg_read_byte(dawg, offset, &byte)) return false;
+        *value |= (uint32_t)(byte & 0x7f) << shift;
+        if(!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Read the label and the skip of the next edge, and its distance if wanted
+static bool dictionary_dawg_read_edge(
+    DictionaryDawg* dawg,
+    uint32_t* offset,
+    uint8_t* label,
+    uint32_t* skip,
+    uint32_t* distance) {
+    return dictionary_dawg_read_byte(dawg, offset, label) && dictionary_dawg_read_varint(dawg, offset, skip) &&
+           (distance == NULL || dictionary_dawg_read_varint(dawg, offset, distance));
+}
+
+// Check the section header and set up the reader
+DictionaryDawg* dictionary_dawg_alloc(DictionaryFile* file, uint32_t offset, uint32_t size) {
+    DictionaryFileDawgHeader header;
+    if(size <= sizeof(header) || !dictionary_file_read(file, offset, &header, sizeof(header)) ||
+       header.root >= size - sizeof(header)) {
+        return NULL;
+    }
+
+    DictionaryDawg* dawg = malloc(sizeof(DictionaryDawg));
+    dawg->file = file;
+    dawg->base = offset + sizeof(header);
+    dawg->size = size - sizeof(header);
+    dawg->root = header.root;
+    dawg->section_size = size;
+    dawg->node_count = header.node_count;
+    dawg->buffer_offset = 0;
+    dawg->buffer_length = 0;
+    return dawg;
+}
+
+// Free the reader
+void dictionary_dawg_free(DictionaryDawg* dawg) {
+    free(dawg);
+}
+
+// Get the root node
+uint32_t dictionary_dawg_get_root(DictionaryDawg* dawg) {
+    return dawg->root;
+}
+
+// Get the size of the section
+uint32_t dictionary_dawg_get_size(DictionaryDawg* dawg) {
+    return dawg->section_size;
+}
+
+// Get the number of nodes
+uint32_t dictionary_dawg_get_node_count(DictionaryDawg* dawg) {
+    return dawg->node_count;
+}
+
+// Follow the edge for one more byte of a prefix
+bool dictionary_dawg_step(
+    DictionaryDawg* dawg,
+    uint32_t* node,
+    uint32_t* first,
+    uint32_t* last,
+    uint8_t label) {
+    uint32_t offset = *node;
+    uint8_t edge_count;
+    if(!dictionary_dawg_read_byte(dawg, &offset, &edge_count)) return false;
+
+    for(uint16_t i = 0; i < edge_count; i++) {
+        uint8_t edge_label;
+        uint32_t skip, distance;
+        if(!dictionary_dawg_read_edge(dawg, &offset, &edge_label, &skip, &distance)) return false;
+
+        // Edges are in byte order, so the byte can't come later
+        if(edge_label > label) return false;
+        if(edge_label < label) continue;
+
+        // The next edge starts where the words of this one end
+        uint32_t end = *last;
+        if(i + 1 < edge_count) {
+            uint8_t next_label;
+            uint32_t next_skip;
+            if(!dictionary_dawg_read_edge(dawg, &offset, &next_label, &next_skip, NULL)) return false;
+            end = *first + next_skip;
+        }
+
+        if(distance == 0 || distance > *node || skip > end - *first || end > *last) {
+            return false;
+        }
+        *first += skip;
+        *last = end;
+        *node -= distance;
+        return true;
+    }
+    return false;
+}
+
+// Start iterating over the edges of a node
+bool dictionary_dawg_edges_start(
+    DictionaryDawg* dawg,
+    DictionaryDawgEdges* edges,
+    uint32_t node,
+    uint32_t first,
+    uint32_t last,
+    bool* final) {
+    uint8_t edge_count;
+    edges->node = node;
+    edges->offset = node;
+    edges->first = first;
+    edges->last = last;
+    edges->remaining = 0;
+    if(!dictionary_dawg_read_byte(dawg, &edges->offset, &edge_count)) return false;
+
+    // A word ending here sorts before the words of the first edge
+    *final = edge_count == 0;
+    if(edge_count > 0) {
+        if(!dictionary_dawg_read_edge(dawg, &edges->offset, &edges->label, &edges->skip, &edges->distance)) {
+            return false;
+        }
+        *final = edges->skip > 0;
+        edges->remaining = edge_count;
+    }
+    return true;
+}
+
+// Get the next edge in byte order
+bool dictionary_dawg_edges_next(DictionaryDawg* dawg, DictionaryDawgEdges* edges, DictionaryDawgEdge* edge) {
+    if(edges->remaining == 0) return false;
+    edges->remaining--;
+
+    edge->label = edges->label;
+    edge->first = edges->first + edges->skip;
+    edge->last = edges->last;
+    if(edges->distance == 0 || edges->distance > edges->node) {
+        edges->remaining = 0;
+        return false;
+    }
+    edge->node = edges->node - edges->distance;
+
+    // The next edge starts where the words of this one end
+    if(edges->remaining > 0) {
+        if(!dictionary_dawg_read_edge(dawg, &edges->offset, &edges->label, &edges->skip, &edges->distance)) {
+            edges->remaining = 0;
+            return false;
+        }
+        edge->last = edges->first + edges->skip;
+    }
+
+    if(edge->first >= edge->last || edge->last > edges->last) {
+        edges->remaining = 0;
+        return false;
+    }
+    return true;
+}
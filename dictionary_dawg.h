@@ -0,0 +1,69 @@
+#pragma once
+
+#include "dictionary_file.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Reader for the DAWG section described in dictionary_format.h
+
+typedef struct DictionaryDawg DictionaryDawg;
+
+// Check the section header and set up the reader, the section stays on
+// storage. Returns NULL if the section is malformed.
+DictionaryDawg* dictionary_dawg_alloc(DictionaryFile* file, uint32_t offset, uint32_t size);
+
+// Free the reader
+void dictionary_dawg_free(DictionaryDawg* dawg);
+
+// Get the root node, the node of the empty prefix
+uint32_t dictionary_dawg_get_root(DictionaryDawg* dawg);
+
+// Get the size of the section and its number of nodes
+uint32_t dictionary_dawg_get_size(DictionaryDawg* dawg);
+uint32_t dictionary_dawg_get_node_count(DictionaryDawg* dawg);
+
+// Follow the edge for one more byte of a prefix. [*first, *last) must be the
+// range of words with the prefix of *node; on success it is narrowed to the
+// words continuing with the byte and *node moves to the next node. Returns
+// false if no word continues with the byte.
+bool dictionary_dawg_step(
+    DictionaryDawg* dawg,
+    uint32_t* node,
+    uint32_t* first,
+    uint32_t* last,
+    uint8_t label);
+
+// Iterator over the edges of a node
+typedef struct {
+    uint32_t node;      // Node the edges leave from
+    uint32_t offset;    // Next unread byte of the node
+    uint32_t first;     // Words of the node are [first, last)
+    uint32_t last;
+    uint16_t remaining; // Edges not returned yet
+    uint8_t label;      // Next edge, already read
+    uint32_t skip;
+    uint32_t distance;
+} DictionaryDawgEdges;
+
+// An edge and the range of words continuing with its byte
+typedef struct {
+    uint8_t label;
+    uint32_t node;
+    uint32_t first;
+    uint32_t last;
+} DictionaryDawgEdge;
+
+// Start iterating over the edges of a node whose words are [first, last).
+// Sets *final if a word ends at the node; that word is then the first one.
+// Returns false if the node is malformed.
+bool dictionary_dawg_edges_start(
+    DictionaryDawg* dawg,
+    DictionaryDawgEdges* edges,
+    uint32_t node,
+    uint32_t first,
+    uint32_t last,
+    bool* final);
+
+// Get the next edge in byte order, returns false after the last one
+bool dictionary_dawg_edges_next(DictionaryDawg* dawg, DictionaryDawgEdges* edges, DictionaryDawgEdge* edge);
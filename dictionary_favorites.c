@@ -0,0 +1,126 @@
+#include "dictionary_favorites.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Words per bitset page, a page takes DICTIONARY_FAVORITES_PAGE_WORDS / 8 bytes
+#define DICTIONARY_FAVORITES_PAGE_WORDS 4096
+#define DICTIONARY_FAVORITES_PAGE_SIZE (DICTIONARY_FAVORITES_PAGE_WORDS / 32)
+
+struct DictionaryFavorites {
+    uint32_t word_count;
+    uint32_t** pages; // NULL until a word of the page is marked
+    uint32_t page_count;
+    uint16_t* page_marks; // Words marked per page, to free empty pages
+
+    uint32_t* list; // Sorted word indices
+    uint32_t count;
+    uint32_t capacity;
+};
+
+// Find the position of a word in the sorted list, or where it would go
+static uint32_t dictionary_favorites_find(DictionaryFavorites* favorites, uint32_t index) {
+    uint32_t low = 0;
+    uint32_t high = favorites->count;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if(favorites->list[mid] < index) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Allocate an empty set
+DictionaryFavorites* dictionary_favorites_alloc(uint32_t word_count) {
+    DictionaryFavorites* favorites = malloc(sizeof(DictionaryFavorites));
+    favorites->word_count = word_count;
+    favorites->page_count = (word_count + DICTIONARY_FAVORITES_PAGE_WORDS - 1) / DICTIONARY_FAVORITES_PAGE_WORDS;
+    favorites->pages = calloc(favorites->page_count ? favorites->page_count : 1, sizeof(uint32_t*));
+    favorites->page_marks = calloc(favorites->page_count ? favorites->page_count : 1, sizeof(uint16_t));
+    favorites->list = NULL;
+    favorites->count = 0;
+    favorites->capacity = 0;
+    return favorites;
+}
+
+// Free the set
+void dictionary_favorites_free(DictionaryFavorites* favorites) {
+    for(uint32_t i = 0; i < favorites->page_count; i++) {
+        free(favorites->pages[i]);
+    }
+    free(favorites->pages);
+    free(favorites->page_marks);
+    free(favorites->list);
+    free(favorites);
+}
+
+// Check if a word is a favorite
+bool dictionary_favorites_contains(DictionaryFavorites* favorites, uint32_t index) {
+    if(index >= favorites->word_count) return false;
+    const uint32_t* page = favorites->pages[index / DICTIONARY_FAVORITES_PAGE_WORDS];
+    if(page == NULL) return false;
+    uint32_t bit = index % DICTIONARY_FAVORITES_PAGE_WORDS;
+    return (page[bit / 32] >> (bit % 32)) & 1;
+}
+
+// Mark a word as a favorite
+bool dictionary_favorites_add(DictionaryFavorites* favorites, uint32_t index) {
+    if(index >= favorites->word_count || dictionary_favorites_contains(favorites, index)) return false;
+
+    uint32_t page_index = index / DICTIONARY_FAVORITES_PAGE_WORDS;
+    if(favorites->pages[page_index] == NULL) {
+        favorites->pages[page_index] = calloc(DICTIONARY_FAVORITES_PAGE_SIZE, sizeof(uint32_t));
+    }
+    uint32_t bit = index % DICTIONARY_FAVORITES_PAGE_WORDS;
+    favorites->pages[page_index][bit / 32] |= 1u << (bit % 32);
+    favorites->page_marks[page_index]++;
+
+    if(favorites->count == favorites->capacity) {
+        favorites->capacity = favorites->capacity ? favorites->capacity * 2 : 16;
+        favorites->list = realloc(favorites->list, favorites->capacity * sizeof(uint32_t));
+    }
+    uint32_t position = dictionary_favorites_find(favorites, index);
+    memmove(
+        &favorites->list[position + 1],
+        &favorites->list[position],
+        (favorites->count - position) * sizeof(uint32_t));
+    favorites->list[position] = index;
+    favorites->count++;
+    return true;
+}
+
+// Unmark a word
+bool dictionary_favorites_remove(DictionaryFavorites* favorites, uint32_t index) {
+    if(!dictionary_favorites_contains(favorites, index)) return false;
+
+    uint32_t page_index = index / DICTIONARY_FAVORITES_PAGE_WORDS;
+    uint32_t bit = index % DICTIONARY_FAVORITES_PAGE_WORDS;
+    favorites->pages[page_index][bit / 32] &= ~(1u << (bit % 32));
+    if(--favorites->page_marks[page_index] == 0) {
+        free(favorites->pages[page_index]);
+        favorites->pages[page_index] = NULL;
+    }
+
+    uint32_t position = dictionary_favorites_find(favorites, index);
+    favorites->count--;
+    memmove(
+        &favorites->list[position],
+        &favorites->list[position + 1],
+        (favorites->count - position) * sizeof(uint32_t));
+    return true;
+}
+
+// Get the number of favorites
+uint32_t dictionary_favorites_get_count(DictionaryFavorites* favorites) {
+    return favorites->count;
+}
+
+// Get the word index of the favorite at a position of the list
+uint32_t dictionary_favorites_get(DictionaryFavorites* favorites, uint32_t position) {
+    furi_assert(position < favorites->count);
+    return favorites->list[position];
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Set of favorite words by word index.
+//
+// Membership is a bitset over the word indices, split into pages that are
+// only allocated once one of their words is marked, so a large dictionary
+// with few favorites costs little memory. The favorites are also kept as a
+// sorted array of indices for the favorites list, in dictionary order.
+
+typedef struct DictionaryFavorites DictionaryFavorites;
+
+// Allocate an empty set for a dictionary of word_count words
+DictionaryFavorites* dictionary_favorites_alloc(uint32_t word_count);
+
+// Free the set
+void dictionary_favorites_free(DictionaryFavorites* favorites);
+
+// Check if a word is a favorite
+bool dictionary_favorites_contains(DictionaryFavorites* favorites, uint32_t index);
+
+// Mark a word as a favorite, returns false if it already was one or is out
+// of range
+bool dictionary_favorites_add(DictionaryFavorites* favorites, uint32_t index);
+
+// Unmark a word, returns false if it was not a favorite
+bool dictionary_favorites_remove(DictionaryFavorites* favorites, uint32_t index);
+
+// Get the number of favorites
+uint32_t dictionary_favorites_get_count(DictionaryFavorites* favorites);
+
+// Get the word index of the favorite at a position of the list
+uint32_t dictionary_favorites_get(DictionaryFavorites* favorites, uint32_t position);
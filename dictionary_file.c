@@ -0,0 +1,169 @@
+#include "dictionary_file.h"
+#include "dictionary_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+#define TAG "DictionaryFile"
+
+#define DICTIONARY_FILE_PAGE_EMPTY UINT32_MAX
+
+// One cached page of the file
+typedef struct {
+    uint32_t index;     // Page number, DICTIONARY_FILE_PAGE_EMPTY if unused
+    uint32_t last_used; // Access tick for least-recently-used replacement
+    uint16_t length;    // Valid bytes, shorter than a page only at end of file
+    uint8_t data[DICTIONARY_FILE_PAGE_SIZE];
+} DictionaryFilePage;
+
+struct DictionaryFile {
+    File* file;
+    uint32_t size;
+    uint32_t tick;
+    DictionaryFilePage pages[DICTIONARY_FILE_PAGE_COUNT];
+};
+
+// Open a file for paged reading, returns NULL if it can't be opened
+DictionaryFile* dictionary_file_open(Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_free(file);
+        return NULL;
+    }
+
+    uint64_t size = storage_file_size(file);
+    if(size > UINT32_MAX) {
+        FURI_LOG_E(TAG, "%s is too large", path);
+        storage_file_close(file);
+        storage_file_free(file);
+        return NULL;
+    }
+
+    DictionaryFile* dictionary_file = malloc(sizeof(DictionaryFile));
+    dictionary_file->file = file;
+    dictionary_file->size = size;
+    dictionary_file->tick = 0;
+    for(uint8_t i = 0; i < DICTIONARY_FILE_PAGE_COUNT; i++) {
+        dictionary_file->pages[i].index = DICTIONARY_FILE_PAGE_EMPTY;
+        dictionary_file->pages[i].last_used = 0;
+        dictionary_file->pages[i].length = 0;
+    }
+
+    return dictionary_file;
+}
+
+// Close the file and release the page cache
+void dictionary_file_close(DictionaryFile* file) {
+    if(file == NULL) return;
+
+    storage_file_close(file->file);
+    storage_file_free(file->file);
+    free(file);
+}
+
+// Get the size of the file in bytes
+uint32_t dictionary_file_get_size(DictionaryFile* file) {
+    return file->size;
+}
+
+// Find a page in the cache, loading it over the least recently used one on a miss
+static DictionaryFilePage* dictionary_file_get_page(DictionaryFile* file, uint32_t index) {
+    DictionaryFilePage* victim = &file->pages[0];
+    file->tick++;
+    DICTIONARY_PROFILE_COUNT(page_lookups, 1);
+
+    for(uint8_t i = 0; i < DICTIONARY_FILE_PAGE_COUNT; i++) {
+        DictionaryFilePage* page = &file->pages[i];
+        if(page->index == index) {
+            page->last_used = file->tick;
+            DICTIONARY_PROFILE_COUNT(page_hits, 1);
+            return page;
+        }
+        if(page->index == DICTIONARY_FILE_PAGE_EMPTY) {
+            victim = page;
+        } else if(victim->index != DICTIONARY_FILE_PAGE_EMPTY &&
+                  page->last_used < victim->last_used) {
+            victim = page;
+        }
+    }
+
+    uint32_t offset = index * DICTIONARY_FILE_PAGE_SIZE;
+    uint32_t length = file->size - offset;
+    if(length > DICTIONARY_FILE_PAGE_SIZE) {
+        length = DICTIONARY_FILE_PAGE_SIZE;
+    }
+
+    victim->index = DICTIONARY_FILE_PAGE_EMPTY;
+    if(!storage_file_seek(file->file, offset, true) ||
+       storage_file_read(file->file, victim->data, length) != length) {
+        FURI_LOG_E(TAG, "Failed to read page %lu", (unsigned long)index);
+        return NULL;
+    }
+
+    DICTIONARY_PROFILE_COUNT(storage_reads, 1);
+    DICTIONARY_PROFILE_COUNT(storage_bytes, length);
+    victim->index = index;
+    victim->length = length;
+    victim->last_used = file->tick;
+    return victim;
+}
+
+// Copy size bytes starting at offset, fails if the range is outside the file
+bool dictionary_file_read(DictionaryFile* file, uint32_t offset, void* buffer, size_t size) {
+    if(offset > file->size || size > file->size - offset) {
+        return false;
+    }
+
+    uint8_t* out = buffer;
+    while(size > 0) {
+        DictionaryFilePage* page = dictionary_file_get_page(file, offset / DICTIONARY_FILE_PAGE_SIZE);
+        if(page == NULL) return false;
+
+        uint32_t page_offset = offset % DICTIONARY_FILE_PAGE_SIZE;
+        size_t chunk = page->length - page_offset;
+        if(chunk > size) {
+            chunk = size;
+        }
+
+        memcpy(out, page->data + page_offset, chunk);
+        out += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+
+    return true;
+}
+
+// Copy a NUL-terminated string starting at offset, truncated to fit the buffer.
+// Returns the string length, or 0 if nothing could be read.
+size_t dictionary_file_read_string(DictionaryFile* file, uint32_t offset, char* buffer, size_t size) {
+    if(size == 0) return 0;
+
+    size_t length = 0;
+    while(offset < file->size && length < size - 1) {
+        DictionaryFilePage* page = dictionary_file_get_page(file, offset / DICTIONARY_FILE_PAGE_SIZE);
+        if(page == NULL) break;
+
+        uint32_t page_offset = offset % DICTIONARY_FILE_PAGE_SIZE;
+        size_t chunk = page->length - page_offset;
+        if(chunk > size - 1 - length) {
+            chunk = size - 1 - length;
+        }
+
+        const uint8_t* start = page->data + page_offset;
+        const uint8_t* end = memchr(start, '\0', chunk);
+        if(end != NULL) {
+            memcpy(buffer + length, start, end - start);
+            length += end - start;
+            break;
+        }
+
+        memcpy(buffer + length, start, chunk);
+        length += chunk;
+        offset += chunk;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "storage/storage.h"
+
+// Paged read-only access to a dictionary image on storage.
+// Reads go through a small fixed page cache, so memory use does not depend
+// on the size of the file.
+
+#define DICTIONARY_FILE_PAGE_SIZE 512
+#define DICTIONARY_FILE_PAGE_COUNT 8
+
+typedef struct DictionaryFile DictionaryFile;
+
+// Open a file for paged reading, returns NULL if it can't be opened
+DictionaryFile* dictionary_file_open(Storage* storage, const char* path);
+
+// Close the file and release the page cache
+void dictionary_file_close(DictionaryFile* file);
+
+// Get the size of the file in bytes
+uint32_t dictionary_file_get_size(DictionaryFile* file);
+
+// Copy size bytes starting at offset, fails if the range is outside the file
+bool dictionary_file_read(DictionaryFile* file, uint32_t offset, void* buffer, size_t size);
+
+// Copy a NUL-terminated string starting at offset, truncated to fit the buffer.
+// Returns the string length, or 0 if nothing could be read.
+size_t dictionary_file_read_string(DictionaryFile* file, uint32_t offset, char* buffer, size_t size);
@@ -0,0 +1,124 @@
+#include "dictionary_fold.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Words left out of the full-text index, in strcmp() order
+static const char* const dictionary_fold_stopwords[] = {
+    "a",    "an",   "and",  "are",   "as",   "at",    "be",   "by",   "for", "from",
+    "in",   "into", "is",   "it",    "its",  "of",    "on",   "or",   "that", "the",
+    "this", "to",   "used", "which", "with",
+};
+
+#define DICTIONARY_FOLD_STOPWORD_COUNT (sizeof(dictionary_fold_stopwords) / sizeof(dictionary_fold_stopwords[0]))
+
+// Fold the alternative starting at text into key
+size_t dictionary_fold_key(const char* text, char* key) {
+    const uint8_t* in = (const uint8_t*)text;
+    uint8_t* out = (uint8_t*)key;
+    size_t length = 0;
+    size_t trimmed = 0; // Length without trailing spaces
+
+    while(*in == ' ') {
+        in++;
+    }
+
+    while(*in != '\0' && !dictionary_fold_is_separator(*in)) {
+        uint8_t first = in[0];
+        uint8_t second = in[1];
+        size_t size = 1;
+
+        if(first >= 'A' && first <= 'Z') {
+            first += 'a' - 'A';
+        } else if(first == 0xd0 && second >= 0x80 && second <= 0xbf) {
+            size = 2;
+            if(second == 0x81) {
+                second = 0xb5; // Ё -> е
+            } else if(second < 0x90) {
+                first = 0xd1; // Ѐ-Џ -> ѐ-џ
+                second += 0x10;
+            } else if(second < 0xa0) {
+                second += 0x20; // А-П -> а-п
+            } else if(second < 0xb0) {
+                first = 0xd1; // Р-Я -> р-я
+                second -= 0x20;
+            }
+        } else if(first == 0xd1 && second == 0x91) {
+            size = 2;
+            first = 0xd0; // ё -> е
+            second = 0xb5;
+        } else if(first >= 0xc0) {
+            // Other multi-byte characters are kept whole
+            while(size < 4 && (in[size] & 0xc0) == 0x80) {
+                size++;
+            }
+        }
+
+        if(length + size > DICTIONARY_FOLD_KEY_MAX) break;
+        out[length] = first;
+        if(size > 1) {
+            out[length + 1] = second;
+            for(size_t i = 2; i < size; i++) {
+                out[length + i] = in[i];
+            }
+        }
+        length += size;
+        in += size;
+        if(first != ' ') {
+            trimmed = length;
+        }
+    }
+
+    out[trimmed] = '\0';
+    return trimmed;
+}
+
+// Check if a word is too common to index
+bool dictionary_fold_is_stopword(const char* token) {
+    size_t low = 0;
+    size_t high = DICTIONARY_FOLD_STOPWORD_COUNT;
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        int result = strcmp(dictionary_fold_stopwords[mid], token);
+        if(result == 0) return true;
+        if(result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+// Check if a byte is part of a full-text word
+static bool dictionary_fold_is_token_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// Get the next word of a text for full-text search
+size_t dictionary_fold_next_token(const char** text, char* token) {
+    const char* in = *text;
+    while(*in != '\0') {
+        // Skip to the start of a word
+        while(*in != '\0' && !dictionary_fold_is_token_char(*in)) {
+            in++;
+        }
+
+        size_t length = 0;
+        while(dictionary_fold_is_token_char(*in)) {
+            if(length < DICTIONARY_FOLD_TOKEN_MAX) {
+                token[length++] = (*in >= 'A' && *in <= 'Z') ? *in + ('a' - 'A') : *in;
+            }
+            in++;
+        }
+        token[length] = '\0';
+
+        if(length > 0 && !dictionary_fold_is_stopword(token)) {
+            *text = in;
+            return length;
+        }
+    }
+    *text = in;
+    return 0;
+}
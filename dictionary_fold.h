@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Search keys for translations and full-text search, shared by the app and
+// the compiler in tools/
+//
+// A translation holds alternatives separated by ',' or ';'. The key of an
+// alternative is its text without surrounding spaces, with ASCII and Cyrillic
+// letters lowercased and ё/Ё folded to е, so "Ёлка" and "елка" find each other.
+
+// Longest key in bytes, without the terminator
+#define DICTIONARY_FOLD_KEY_MAX 63
+
+// Fold the alternative starting at text into key, which must hold
+// DICTIONARY_FOLD_KEY_MAX + 1 bytes. Longer keys are cut at a character
+// boundary. Returns the key length.
+size_t dictionary_fold_key(const char* text, char* key);
+
+// Check if a byte separates two alternatives
+#define dictionary_fold_is_separator(c) ((c) == ',' || (c) == ';')
+
+// Words of a definition for full-text search are runs of ASCII letters and
+// digits, lowercased and cut to DICTIONARY_FOLD_TOKEN_MAX bytes. Words too
+// common to narrow a search down ("a", "the", "with"...) are left out.
+#define DICTIONARY_FOLD_TOKEN_MAX 23
+
+// Get the next word of a text and move *text past it. token must hold
+// DICTIONARY_FOLD_TOKEN_MAX + 1 bytes. Returns the word length, or 0 at the
+// end of the text.
+size_t dictionary_fold_next_token(const char** text, char* token);
+
+// Check if a lowercase word is one of the words left out as too common
+bool dictionary_fold_is_stopword(const char* token);
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <stdint.h>
+
+// On-storage dictionary image (.dict)
+//
+// Shared by the app and the host-side compiler in tools/. All integers are
+// little-endian. The file starts with a DictionaryFileHeader followed by
+// section_count DictionaryFileSection records; each section is located by its
+// absolute offset so new sections can be added without moving old ones, and
+// the sections may follow the table in any order.
+//
+// Version 9 layout:
+//   Word index section - uint32_t offset of each word block in the word data,
+//                        plus one closing offset holding the data size
+//   Word data section  - front-coded word blocks
+//   Codec section      - DictionaryFileCodecHeader, one code length per symbol,
+//                        phrase_count + 1 uint16_t phrase offsets, phrase bytes
+//   Text index section - DictionaryFileTextBlock per block, plus one closing
+//                        record holding entry_count and the data size
+//   Text data section  - compressed text blocks
+//   DAWG section       - DictionaryFileDawgHeader, then the DAWG nodes
+//   Reverse section    - DictionaryFileReverseRecord per translation alternative
+//   Terms section      - DictionaryFileTerm per definition word, in strcmp()
+//                        order, plus one closing record holding the sizes of
+//                        the other two sections
+//   Term strings       - NUL-terminated definition words
+//   Postings section   - posting lists of the definition words
+//   Letters section    - 257 uint32_t, entry b is the first entry whose word
+//                        starts with a byte of at least b, the last one
+//                        holds entry_count
+//   Ranks section      - uint8_t frequency rank per entry, then tiers of
+//                        maxima (see below)
+//   Bigrams section    - uint16_t row number per first byte, then a row of
+//                        DICTIONARY_BIGRAM_COLUMNS uint32_t per first byte
+//                        some word starts with, in byte order; column c of
+//                        the row of byte b is the first entry whose word is
+//                        not less than byte b followed by 'a' + c
+//
+// Entries are stored in strcmp() order of their words without duplicates.
+// The compiler sorts them and sets DICTIONARY_FILE_FLAG_SORTED, so the app
+// only has to check the flag instead of scanning the whole file at startup.
+// Every index is precomputed by the compiler; the app reads them in place.
+//
+// Words are front-coded in blocks of DICTIONARY_WORD_BLOCK_ENTRIES: the first
+// word of a block is stored whole and NUL-terminated, every following word as
+// one byte with the length of the prefix it shares with the word before it and
+// the NUL-terminated rest. Block b holds entries b * DICTIONARY_WORD_BLOCK_ENTRIES
+// onwards, so the word index doubles as a sparse index of first words.
+//
+// The DAWG section is a minimal automaton of the words in which each edge
+// also says how many words sort in front of it, so walking one node per letter
+// narrows the range of words with that prefix. A node is one byte with its
+// edge count followed by its edges in byte order; an edge is its byte, a
+// varint with the number of words below the node in front of the edge (the
+// word ending at the node, if any, comes first) and a varint with the distance
+// back from the node to the node the edge leads to. Children always come
+// before their parents and the root is the last node. Varints store 7 bits
+// per byte, low bits first, with the top bit set on all but the last byte.
+//
+// The reverse section indexes the translations for Russian to English search.
+// Each alternative of a translation (see dictionary_fold.h) gets a record
+// pointing at its first byte inside the entry's translation, and the records
+// are sorted by the folded key of that alternative, then by entry. The text
+// itself is only stored once, in the text blocks.
+//
+// The terms and postings sections are an inverted index of the definitions
+// for full-text search; words are split and filtered as in dictionary_fold.h.
+// The posting list of a word holds the entries whose definition contains it,
+// in ascending order, as varints (see the DAWG section) of the difference to
+// the entry before, the first one counting from 0.
+//
+// The ranks section gives each entry a frequency rank, 0 for unknown and
+// higher for more frequent words, growing with the logarithm of the count.
+// Tier 0 holds the rank of each entry; every following tier holds the
+// largest value of each DICTIONARY_RANK_FANOUT consecutive values of the tier
+// before, the last tier having a single value. The tiers let the app find the
+// most frequent words of a range by only descending into promising groups.
+//
+// The letters and bigrams sections split the word list into buckets of
+// words sharing their first byte, and within a bucket into runs sharing
+// their second letter: the bucket of byte b ends where the one of b + 1
+// starts and its runs start at the columns of the row of b. Bytes no word
+// starts with get no row, their row number is 0. The last column,
+// 'z' + 1, starts the words continuing with anything past 'z'. Together they
+// let the app jump to the next or previous letter in a few reads.
+//
+// Definitions and translations are stored as "definition\0translation\0" per
+// entry, grouped into blocks of consecutive entries of at most
+// DICTIONARY_TEXT_BLOCK_SIZE bytes. Each block is compressed on its own:
+// the text is split into symbols, either a single byte (0-255) or one of the
+// phrases trained on the corpus (256 and up), and the symbols are written as
+// canonical Huffman codes, most significant bit first. A block starts on a
+// byte boundary.
+
+#define DICTIONARY_FILE_MAGIC 0x54434944 // "DICT"
+#define DICTIONARY_FILE_VERSION 9
+
+// Header flags
+#define DICTIONARY_FILE_FLAG_SORTED (1 << 0)
+
+// Longest word and definition/translation in bytes, without the terminator
+#define DICTIONARY_WORD_MAX 63
+#define DICTIONARY_TEXT_MAX 1023
+
+// Words per front-coded word block and the largest encoded block
+#define DICTIONARY_WORD_BLOCK_ENTRIES 16
+#define DICTIONARY_WORD_BLOCK_SIZE (DICTIONARY_WORD_BLOCK_ENTRIES * (DICTIONARY_WORD_MAX + 2))
+
+// Largest decompressed text block, always fits one entry
+#define DICTIONARY_TEXT_BLOCK_SIZE (2 * (DICTIONARY_TEXT_MAX + 1))
+
+// Codec limits
+#define DICTIONARY_CODEC_LITERALS 256
+#define DICTIONARY_CODEC_PHRASES_MAX 512
+#define DICTIONARY_CODEC_PHRASE_MAX 16
+#define DICTIONARY_CODEC_CODE_MAX 15
+
+// Records of the letters section, row numbers of the bigrams section and
+// records per row: the letters 'a' to 'z' and the byte after them
+#define DICTIONARY_LETTER_COUNT 257
+#define DICTIONARY_BIGRAM_ROWS 256
+#define DICTIONARY_BIGRAM_COLUMNS 27
+
+// Values per group of the ranks section, and enough tiers for 2^32 entries
+#define DICTIONARY_RANK_FANOUT 16
+#define DICTIONARY_RANK_TIERS_MAX 9
+
+typedef enum {
+    DictionarySectionWordIndex = 1,
+    DictionarySectionWordData = 2,
+    DictionarySectionCodec = 3,
+    DictionarySectionTextIndex = 4,
+    DictionarySectionTextData = 5,
+    DictionarySectionDawg = 6,
+    DictionarySectionReverse = 7,
+    DictionarySectionTerms = 8,
+    DictionarySectionTermStrings = 9,
+    DictionarySectionPostings = 10,
+    DictionarySectionLetters = 11,
+    DictionarySectionRanks = 12,
+    DictionarySectionBigrams = 13,
+} DictionarySectionId;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t section_count;
+    uint32_t entry_count;
+    uint16_t flags;
+    uint16_t max_text_length; // Longest definition or translation in this file
+} DictionaryFileHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t id;
+    uint32_t offset;
+    uint32_t size;
+} DictionaryFileSection;
+
+typedef struct __attribute__((packed)) {
+    uint16_t symbol_count;    // DICTIONARY_CODEC_LITERALS + phrase count
+    uint16_t max_packed_size; // Largest compressed block
+} DictionaryFileCodecHeader;
+
+// Text blocks, offsets are relative to the start of the text data section
+typedef struct __attribute__((packed)) {
+    uint32_t first_entry;
+    uint32_t offset;
+} DictionaryFileTextBlock;
+
+// DAWG nodes follow the header, offsets are relative to the first node
+typedef struct __attribute__((packed)) {
+    uint32_t root;       // Offset of the root node
+    uint32_t node_count; // Number of nodes, for reporting
+} DictionaryFileDawgHeader;
+
+// Translation alternative, offset is in bytes from the start of the translation
+typedef struct __attribute__((packed)) {
+    uint32_t entry;
+    uint16_t offset;
+} DictionaryFileReverseRecord;
+
+// Definition word, offsets are relative to the term strings and postings sections
+typedef struct __attribute__((packed)) {
+    uint32_t string_offset;
+    uint32_t postings_offset;
+    uint32_t count; // Entries in the posting list
+} DictionaryFileTerm;
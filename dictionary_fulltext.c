@@ -0,0 +1,270 @@
+#include "dictionary_fulltext.h"
+#include "dictionary_fold.h"
+#include "dictionary_format.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Bytes of a posting list read ahead at a time
+#define DICTIONARY_FULLTEXT_BUFFER_SIZE 32
+
+// Position in the posting list of one query word
+typedef struct {
+    uint32_t offset;    // Next unread byte of the list
+    uint32_t end;       // End of the list
+    uint32_t remaining; // Entries not read yet
+    uint32_t entry;     // Current entry
+    uint8_t buffer[DICTIONARY_FULLTEXT_BUFFER_SIZE];
+    uint32_t buffer_offset; // buffer[0] is the byte at buffer_offset
+    uint32_t buffer_length;
+} DictionaryFulltextCursor;
+
+struct DictionaryFulltext {
+    DictionaryFile* file;
+    uint32_t entry_count;
+    uint32_t terms_base;
+    uint32_t term_count;
+    uint32_t strings_base;
+    uint32_t postings_base;
+    uint32_t postings_size;
+    uint32_t size;
+
+    DictionaryFulltextCursor cursors[DICTIONARY_FULLTEXT_QUERY_WORDS];
+    char term_buffer[DICTIONARY_FOLD_TOKEN_MAX + 1];
+
+    // Progress of the running search
+    DictionaryDataProgress progress;
+    void* progress_context;
+    uint32_t steps;
+    uint32_t found;
+};
+
+// Read a term record, index term_count is the closing record
+static bool dictionary_fulltext_read_term(DictionaryFulltext* fulltext, uint32_t index, DictionaryFileTerm* term) {
+    return dictionary_file_read(
+        fulltext->file, fulltext->terms_base + index * sizeof(DictionaryFileTerm), term, sizeof(DictionaryFileTerm));
+}
+
+// Find the posting list of a word, returns false if it is not indexed
+static bool dictionary_fulltext_find_term(
+    DictionaryFulltext* fulltext,
+    const char* word,
+    DictionaryFulltextCursor* cursor) {
+    uint32_t low = 0;
+    uint32_t high = fulltext->term_count;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        DictionaryFileTerm term;
+        if(!dictionary_fulltext_read_term(fulltext, mid, &term) ||
+           dictionary_file_read_string(
+               fulltext->file,
+               fulltext->strings_base + term.string_offset,
+               fulltext->term_buffer,
+               sizeof(fulltext->term_buffer)) == 0) {
+            return false;
+        }
+
+        int result = strcmp(fulltext->term_buffer, word);
+        if(result < 0) {
+            low = mid + 1;
+        } else if(result > 0) {
+            high = mid;
+        } else {
+            DictionaryFileTerm next;
+            if(!dictionary_fulltext_read_term(fulltext, mid + 1, &next) ||
+               term.postings_offset > next.postings_offset || next.postings_offset > fulltext->postings_size ||
+               term.count == 0) {
+                return false;
+            }
+            cursor->offset = term.postings_offset;
+            cursor->end = next.postings_offset;
+            cursor->remaining = term.count;
+            cursor->entry = 0;
+            cursor->buffer_offset = 0;
+            cursor->buffer_length = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Read the next byte of a posting list
+static bool dictionary_fulltext_read_byte(
+    DictionaryFulltext* fulltext,
+    DictionaryFulltextCursor* cursor,
+    uint8_t* byte) {
+    if(cursor->offset >= cursor->end) return false;
+
+    if(cursor->offset < cursor->buffer_offset || cursor->offset >= cursor->buffer_offset + cursor->buffer_length) {
+        uint32_t length = cursor->end - cursor->offset;
+        if(length > DICTIONARY_FULLTEXT_BUFFER_SIZE) {
+            length = DICTIONARY_FULLTEXT_BUFFER_SIZE;
+        }
+        if(!dictionary_file_read(fulltext->file, fulltext->postings_base + cursor->offset, cursor->buffer, length)) {
+            cursor->buffer_length = 0;
+            return false;
+        }
+        cursor->buffer_offset = cursor->offset;
+        cursor->buffer_length = length;
+    }
+
+    *byte = cursor->buffer[cursor->offset - cursor->buffer_offset];
+    cursor->offset++;
+    return true;
+}
+
+// Move a cursor to its next entry, returns false at the end of the list
+static bool dictionary_fulltext_next(DictionaryFulltext* fulltext, DictionaryFulltextCursor* cursor, bool first) {
+    if(cursor->remaining == 0) return false;
+
+    uint32_t delta = 0;
+    for(uint8_t shift = 0;; shift += 7) {
+        uint8_t byte;
+        if(shift >= 32 || !dictionary_fulltext_read_byte(fulltext, cursor, &byte)) {
+            cursor->remaining = 0;
+            return false;
+        }
+        delta |= (uint32_t)(byte & 0x7f) << shift;
+        if(!(byte & 0x80)) break;
+    }
+
+    // Entries after the first must be strictly ascending and all in range
+    if((!first && delta == 0) || delta >= fulltext->entry_count - cursor->entry) {
+        cursor->remaining = 0;
+        return false;
+    }
+    cursor->entry += delta;
+    cursor->remaining--;
+    return true;
+}
+
+// Count a posting read and report the progress every so often, returns
+// false if the search is to stop
+static bool dictionary_fulltext_step(DictionaryFulltext* fulltext) {
+    if(fulltext->progress == NULL || ++fulltext->steps % DICTIONARY_DATA_PROGRESS_STEPS != 0) return true;
+    return fulltext->progress(fulltext->found, fulltext->progress_context);
+}
+
+// Move a cursor to its first entry not less than target, returns false at
+// the end of the list or if the search is to stop
+static bool dictionary_fulltext_seek(DictionaryFulltext* fulltext, DictionaryFulltextCursor* cursor, uint32_t target) {
+    while(cursor->entry < target) {
+        if(!dictionary_fulltext_next(fulltext, cursor, false) || !dictionary_fulltext_step(fulltext)) return false;
+    }
+    return true;
+}
+
+// Check the sections and set up the reader
+DictionaryFulltext* dictionary_fulltext_alloc(
+    DictionaryFile* file,
+    uint32_t entry_count,
+    uint32_t terms_offset,
+    uint32_t terms_size,
+    uint32_t strings_offset,
+    uint32_t strings_size,
+    uint32_t postings_offset,
+    uint32_t postings_size) {
+    if(terms_size < sizeof(DictionaryFileTerm) || terms_size % sizeof(DictionaryFileTerm) != 0) {
+        return NULL;
+    }
+
+    // The closing record must agree with the section table
+    uint32_t term_count = terms_size / sizeof(DictionaryFileTerm) - 1;
+    DictionaryFileTerm end;
+    if(!dictionary_file_read(file, terms_offset + term_count * sizeof(end), &end, sizeof(end)) ||
+       end.string_offset != strings_size || end.postings_offset != postings_size) {
+        return NULL;
+    }
+
+    DictionaryFulltext* fulltext = malloc(sizeof(DictionaryFulltext));
+    fulltext->file = file;
+    fulltext->entry_count = entry_count;
+    fulltext->terms_base = terms_offset;
+    fulltext->term_count = term_count;
+    fulltext->strings_base = strings_offset;
+    fulltext->postings_base = postings_offset;
+    fulltext->postings_size = postings_size;
+    fulltext->size = terms_size + strings_size + postings_size;
+    return fulltext;
+}
+
+// Free the reader
+void dictionary_fulltext_free(DictionaryFulltext* fulltext) {
+    free(fulltext);
+}
+
+// Get the number of distinct definition words
+uint32_t dictionary_fulltext_get_term_count(DictionaryFulltext* fulltext) {
+    return fulltext->term_count;
+}
+
+// Get the size of the index
+uint32_t dictionary_fulltext_get_size(DictionaryFulltext* fulltext) {
+    return fulltext->size;
+}
+
+// Find the entries whose definition contains every word of a query
+uint32_t dictionary_fulltext_search(
+    DictionaryFulltext* fulltext,
+    const char* query,
+    uint32_t* results,
+    uint32_t max_results,
+    DictionaryDataProgress progress,
+    void* context) {
+    if(fulltext == NULL) return 0;
+    fulltext->progress = progress;
+    fulltext->progress_context = context;
+    fulltext->steps = 0;
+    fulltext->found = 0;
+
+    char word[DICTIONARY_FOLD_TOKEN_MAX + 1];
+    DictionaryFulltextCursor* cursors = fulltext->cursors;
+    uint8_t count = 0;
+    while(count < DICTIONARY_FULLTEXT_QUERY_WORDS && dictionary_fold_next_token(&query, word) > 0) {
+        if(!dictionary_fulltext_find_term(fulltext, word, &cursors[count])) return 0;
+
+        // Keep the lists ordered by length so the rarest word leads
+        uint8_t position = count++;
+        while(position > 0 && cursors[position - 1].remaining > cursors[position].remaining) {
+            DictionaryFulltextCursor cursor = cursors[position - 1];
+            cursors[position - 1] = cursors[position];
+            cursors[position] = cursor;
+            position--;
+        }
+    }
+    if(count == 0) return 0;
+
+    for(uint8_t i = 0; i < count; i++) {
+        if(!dictionary_fulltext_next(fulltext, &cursors[i], true)) return 0;
+    }
+
+    // Leapfrog: move every list up to the candidate of the rarest one, and
+    // take the furthest entry reached as the next candidate when one skips it
+    uint32_t total = 0;
+    uint32_t candidate = cursors[0].entry;
+    for(;;) {
+        uint8_t agreed = 0;
+        for(uint8_t i = 0; i < count; i++) {
+            if(!dictionary_fulltext_seek(fulltext, &cursors[i], candidate)) return total;
+            if(cursors[i].entry == candidate) {
+                agreed++;
+            } else {
+                candidate = cursors[i].entry;
+                break;
+            }
+        }
+
+        if(agreed == count) {
+            if(total < max_results) {
+                results[total] = candidate;
+            }
+            total++;
+            fulltext->found = total;
+            if(!dictionary_fulltext_next(fulltext, &cursors[0], false) || !dictionary_fulltext_step(fulltext)) {
+                return total;
+            }
+            candidate = cursors[0].entry;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "dictionary_data.h"
+#include "dictionary_file.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Reader for the full-text index described in dictionary_format.h. A query
+// matches the entries whose definition contains all of its words; the posting
+// lists are intersected straight from storage, rarest word first, without
+// building any list in memory.
+
+// Most words of a query that are looked up, later ones are ignored
+#define DICTIONARY_FULLTEXT_QUERY_WORDS 4
+
+typedef struct DictionaryFulltext DictionaryFulltext;
+
+// Check the sections and set up the reader, they stay on storage. Returns
+// NULL if they are malformed.
+DictionaryFulltext* dictionary_fulltext_alloc(
+    DictionaryFile* file,
+    uint32_t entry_count,
+    uint32_t terms_offset,
+    uint32_t terms_size,
+    uint32_t strings_offset,
+    uint32_t strings_size,
+    uint32_t postings_offset,
+    uint32_t postings_size);
+
+// Free the reader
+void dictionary_fulltext_free(DictionaryFulltext* fulltext);
+
+// Get the number of distinct definition words and the size of the index
+uint32_t dictionary_fulltext_get_term_count(DictionaryFulltext* fulltext);
+uint32_t dictionary_fulltext_get_size(DictionaryFulltext* fulltext);
+
+// Find the entries whose definition contains every word of a query, in
+// ascending order. Writes the first max_results of them and returns how many
+// there are in total; a query without any indexed word matches nothing.
+// Progress is reported per posting read, see DictionaryDataProgress.
+uint32_t dictionary_fulltext_search(
+    DictionaryFulltext* fulltext,
+    const char* query,
+    uint32_t* results,
+    uint32_t max_results,
+    DictionaryDataProgress progress,
+    void* context);
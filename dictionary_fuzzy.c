@@ -0,0 +1,111 @@
+#include "dictionary_fuzzy.h"
+#include "dictionary_format.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Add a match, keeping the list ordered by distance. The walk finds words in
+// alphabetical order, so a new match goes after those as close as it is.
+static void dictionary_fuzzy_add_match(
+    DictionaryMatch* matches,
+    uint32_t* count,
+    uint32_t max_matches,
+    uint32_t index,
+    uint8_t distance) {
+    uint32_t position = *count;
+    while(position > 0 && matches[position - 1].distance > distance) {
+        position--;
+    }
+    if(position >= max_matches) return;
+
+    uint32_t moved = (*count < max_matches ? *count : max_matches - 1) - position;
+    memmove(&matches[position + 1], &matches[position], moved * sizeof(DictionaryMatch));
+    matches[position].index = index;
+    matches[position].distance = distance;
+    if(*count < max_matches) {
+        (*count)++;
+    }
+}
+
+// Find the words of a DAWG within max_distance edits of a word
+uint32_t dictionary_fuzzy_search(
+    DictionaryDawg* dawg,
+    uint32_t word_count,
+    const char* word,
+    uint8_t max_distance,
+    DictionaryMatch* matches,
+    uint32_t max_matches,
+    DictionaryDataProgress progress,
+    void* context) {
+    size_t length = strlen(word);
+    if(dawg == NULL || word_count == 0 || max_matches == 0 || length > DICTIONARY_WORD_MAX) return 0;
+    if(max_distance > DICTIONARY_FUZZY_DISTANCE_MAX) {
+        max_distance = DICTIONARY_FUZZY_DISTANCE_MAX;
+    }
+
+    // A match is at most max_distance letters longer than the word
+    size_t max_depth = length + max_distance;
+    if(max_depth > DICTIONARY_WORD_MAX) {
+        max_depth = DICTIONARY_WORD_MAX;
+    }
+
+    // One edge iterator and one distance row per letter of the current path
+    size_t row_size = length + 1;
+    DictionaryDawgEdges* frames = malloc((max_depth + 1) * sizeof(DictionaryDawgEdges));
+    uint8_t* rows = malloc((max_depth + 1) * row_size);
+
+    for(size_t j = 0; j <= length; j++) {
+        rows[j] = j;
+    }
+
+    uint32_t count = 0;
+    uint32_t steps = 0;
+    int bound = max_distance;
+    bool final;
+    size_t depth = 0;
+    bool walking = dictionary_dawg_edges_start(dawg, &frames[0], dictionary_dawg_get_root(dawg), 0, word_count, &final);
+
+    while(walking && bound >= 0) {
+        if(progress != NULL && ++steps % DICTIONARY_DATA_PROGRESS_STEPS == 0 && !progress(count, context)) break;
+
+        DictionaryDawgEdge edge;
+        if(!dictionary_dawg_edges_next(dawg, &frames[depth], &edge)) {
+            if(depth == 0) break;
+            depth--;
+            continue;
+        }
+
+        // Distances from the path plus this letter to each prefix of the word
+        const uint8_t* row = rows + depth * row_size;
+        uint8_t* next = rows + (depth + 1) * row_size;
+        uint8_t row_min = next[0] = row[0] + 1;
+        for(size_t j = 1; j <= length; j++) {
+            uint8_t cost = row[j - 1] + ((uint8_t)word[j - 1] != edge.label);
+            if(row[j] + 1 < cost) cost = row[j] + 1;
+            if(next[j - 1] + 1 < cost) cost = next[j - 1] + 1;
+            next[j] = cost;
+            if(cost < row_min) row_min = cost;
+        }
+        if(row_min > bound) continue;
+
+        if(!dictionary_dawg_edges_start(dawg, &frames[depth + 1], edge.node, edge.first, edge.last, &final)) {
+            continue;
+        }
+        if(final && next[length] <= bound) {
+            dictionary_fuzzy_add_match(matches, &count, max_matches, edge.first, next[length]);
+
+            // With the list full only strictly closer words can get in
+            if(count == max_matches) {
+                bound = matches[count - 1].distance - 1;
+            }
+        }
+        if(depth + 1 < max_depth) {
+            depth++;
+        }
+    }
+
+    free(rows);
+    free(frames);
+    return count;
+}
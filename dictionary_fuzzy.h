@@ -0,0 +1,24 @@
+#pragma once
+
+#include "dictionary_data.h"
+#include "dictionary_dawg.h"
+
+// Typo-tolerant lookup over the DAWG: a depth-first walk that carries one
+// row of the Levenshtein distance table per letter and leaves a branch as
+// soon as every entry of the row is over the allowed distance.
+
+// Largest supported edit distance
+#define DICTIONARY_FUZZY_DISTANCE_MAX 2
+
+// Find up to max_matches of the word_count words in a DAWG within
+// max_distance edits of a word, closest first. Returns the number found.
+// Progress is reported per edge walked, see DictionaryDataProgress.
+uint32_t dictionary_fuzzy_search(
+    DictionaryDawg* dawg,
+    uint32_t word_count,
+    const char* word,
+    uint8_t max_distance,
+    DictionaryMatch* matches,
+    uint32_t max_matches,
+    DictionaryDataProgress progress,
+    void* context);
@@ -0,0 +1,35 @@
+// Generated from data/glyphs.tsv by tools/dictionary_glyphs, do not edit
+#include "dictionary_glyphs.h"
+
+const uint8_t dictionary_glyphs_widths[DictionaryGlyphsFontCount][DICTIONARY_GLYPHS_COUNT] = {
+    // FontPrimary
+    {
+        3, 3, 4, 5, 5, 8, 6, 2, 3, 3, 4, 5, 3, 3, 3, 3,
+        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 3, 5, 5, 5, 5,
+        9, 6, 6, 6, 6, 6, 5, 7, 6, 3, 5, 6, 5, 7, 6, 7,
+        6, 7, 6, 6, 5, 6, 6, 8, 6, 6, 5, 3, 3, 3, 5, 5,
+        3, 5, 5, 5, 5, 5, 3, 5, 5, 3, 3, 5, 3, 8, 5, 5,
+        5, 5, 4, 5, 3, 5, 5, 7, 5, 5, 5, 4, 3, 4, 5, 7,
+        7, 8, 7, 7, 7, 3, 3, 5, 10, 10, 8, 7, 7, 7, 7, 7,
+        7, 7, 6, 7, 7, 9, 7, 7, 7, 7, 7, 9, 7, 7, 7, 7,
+        7, 7, 7, 9, 7, 7, 7, 9, 10, 8, 9, 7, 7, 10, 7, 5,
+        5, 5, 4, 5, 5, 8, 5, 5, 5, 5, 5, 7, 5, 5, 5, 5,
+        5, 5, 5, 7, 5, 5, 5, 8, 9, 6, 7, 5, 5, 8, 5, 5,
+        5, 5, 5, 5, 5, 3, 3, 3, 8, 8, 5, 5, 5, 5, 5, 8,
+    },
+    // FontSecondary
+    {
+        3, 2, 4, 6, 5, 6, 6, 2, 3, 3, 4, 4, 2, 4, 2, 4,
+        5, 4, 5, 5, 5, 5, 5, 5, 5, 5, 2, 2, 4, 4, 4, 5,
+        6, 5, 5, 5, 5, 5, 5, 5, 5, 4, 5, 5, 5, 6, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 6, 5, 5, 5, 3, 4, 3, 4, 5,
+        3, 5, 5, 5, 5, 5, 4, 5, 5, 2, 3, 5, 2, 6, 5, 5,
+        5, 5, 4, 5, 4, 5, 5, 6, 5, 5, 5, 4, 2, 4, 5, 5,
+        5, 6, 5, 5, 5, 4, 4, 5, 7, 7, 6, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 6, 5, 5, 5, 5, 5, 6, 5, 5, 5, 5,
+        5, 5, 5, 6, 5, 5, 5, 6, 7, 6, 6, 5, 5, 6, 5, 5,
+        5, 5, 4, 5, 5, 6, 5, 5, 5, 5, 5, 6, 5, 5, 5, 5,
+        5, 5, 5, 6, 5, 5, 5, 6, 7, 6, 6, 5, 5, 6, 5, 5,
+        5, 5, 5, 5, 5, 2, 4, 3, 7, 7, 5, 5, 5, 5, 5, 6,
+    },
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// Advance widths in pixels of the glyphs of the app's fonts, for laying text
+// out without a canvas. The tables are compiled from data/glyphs.tsv into
+// dictionary_glyphs.c by `make -C tools assets`.
+//
+// Each table holds printable ASCII, then Cyrillic U+0400 to U+045F, then one
+// width for every other character.
+
+#define DICTIONARY_GLYPHS_LATIN_FIRST 0x20
+#define DICTIONARY_GLYPHS_LATIN_COUNT 95
+#define DICTIONARY_GLYPHS_CYRILLIC_FIRST 0x400
+#define DICTIONARY_GLYPHS_CYRILLIC_COUNT 96
+#define DICTIONARY_GLYPHS_COUNT (DICTIONARY_GLYPHS_LATIN_COUNT + DICTIONARY_GLYPHS_CYRILLIC_COUNT + 1)
+
+typedef enum {
+    DictionaryGlyphsFontPrimary,
+    DictionaryGlyphsFontSecondary,
+    DictionaryGlyphsFontCount,
+} DictionaryGlyphsFont;
+
+extern const uint8_t dictionary_glyphs_widths[DictionaryGlyphsFontCount][DICTIONARY_GLYPHS_COUNT];
+
+// Get the position of a code point, a uint32_t, in the tables
+#define dictionary_glyphs_get_slot(code)                                                                   \
+    ((code) - DICTIONARY_GLYPHS_LATIN_FIRST < DICTIONARY_GLYPHS_LATIN_COUNT ?                               \
+         (code) - DICTIONARY_GLYPHS_LATIN_FIRST :                                                           \
+     (code) - DICTIONARY_GLYPHS_CYRILLIC_FIRST < DICTIONARY_GLYPHS_CYRILLIC_COUNT ?                         \
+         DICTIONARY_GLYPHS_LATIN_COUNT + (code) - DICTIONARY_GLYPHS_CYRILLIC_FIRST :                        \
+         DICTIONARY_GLYPHS_COUNT - 1)
@@ -0,0 +1,306 @@
+#include "dictionary_journal.h"
+#include "dictionary_format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+#define TAG "DictionaryJournal"
+
+// The file starts with this magic, then holds records of a type byte, a
+// length byte, the word and a CRC-8 of all of them
+#define DICTIONARY_JOURNAL_MAGIC 0x4c4e4a44 // "DJNL"
+#define DICTIONARY_JOURNAL_RECORD_MAX (DICTIONARY_WORD_MAX + 3)
+
+// Bytes read at a time while replaying, holds at least one record
+#define DICTIONARY_JOURNAL_BUFFER_SIZE 256
+
+// Records allowed on top of twice the state before compacting
+#define DICTIONARY_JOURNAL_SLACK 32
+
+#define DICTIONARY_JOURNAL_PATH_MAX 96
+
+struct DictionaryJournal {
+    Storage* storage;
+    File* file;
+    bool file_open;     // The file is open on path, at its end
+    bool torn;          // An append failed and may have left part of a record
+    bool rename_failed; // Compaction is off until the next start
+    char path[DICTIONARY_JOURNAL_PATH_MAX];
+    char temporary_path[DICTIONARY_JOURNAL_PATH_MAX];
+    uint32_t record_count;
+};
+
+// Buffered reader over the journal file
+typedef struct {
+    File* file;
+    uint8_t data[DICTIONARY_JOURNAL_BUFFER_SIZE];
+    size_t start;
+    size_t end;
+} DictionaryJournalReader;
+
+// CRC-8 with polynomial 0x07
+static uint8_t dictionary_journal_crc(const uint8_t* data, size_t size) {
+    uint8_t crc = 0;
+    for(size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Make size bytes available from the start of the buffer, returns false at
+// the end of the file
+static bool dictionary_journal_fill(DictionaryJournalReader* reader, size_t size) {
+    if(reader->end - reader->start >= size) return true;
+
+    memmove(reader->data, reader->data + reader->start, reader->end - reader->start);
+    reader->end -= reader->start;
+    reader->start = 0;
+    reader->end += storage_file_read(reader->file, reader->data + reader->end, sizeof(reader->data) - reader->end);
+    return reader->end >= size;
+}
+
+static bool dictionary_journal_write_header(File* file) {
+    uint32_t magic = DICTIONARY_JOURNAL_MAGIC;
+    return storage_file_write(file, &magic, sizeof(magic)) == sizeof(magic);
+}
+
+static bool dictionary_journal_write_record(File* file, DictionaryJournalRecordType type, const char* word) {
+    size_t length = strlen(word);
+    if(length == 0 || length > DICTIONARY_WORD_MAX) return false;
+
+    uint8_t record[DICTIONARY_JOURNAL_RECORD_MAX];
+    record[0] = type;
+    record[1] = length;
+    memcpy(record + 2, word, length);
+    record[length + 2] = dictionary_journal_crc(record, length + 2);
+    return storage_file_write(file, record, length + 3) == length + 3;
+}
+
+// Replay the records and cut the file after the last intact one
+static bool dictionary_journal_replay(
+    DictionaryJournal* journal,
+    DictionaryJournalReplayCallback callback,
+    void* context) {
+    DictionaryJournalReader* reader = malloc(sizeof(DictionaryJournalReader));
+    reader->file = journal->file;
+    reader->start = 0;
+    reader->end = 0;
+
+    uint64_t size = storage_file_size(journal->file);
+    uint32_t offset = 0; // End of the last intact record
+    uint32_t magic;
+    if(dictionary_journal_fill(reader, sizeof(magic))) {
+        memcpy(&magic, reader->data, sizeof(magic));
+        if(magic == DICTIONARY_JOURNAL_MAGIC) {
+            offset = sizeof(magic);
+            reader->start = sizeof(magic);
+        }
+    }
+
+    char word[DICTIONARY_WORD_MAX + 1];
+    while(offset > 0 && dictionary_journal_fill(reader, 2)) {
+        const uint8_t* record = reader->data + reader->start;
+        uint8_t type = record[0];
+        uint8_t length = record[1];
+        if(type < DictionaryJournalFavoriteAdd || type > DictionaryJournalLookup || length == 0 ||
+           length > DICTIONARY_WORD_MAX || !dictionary_journal_fill(reader, length + 3)) {
+            break;
+        }
+        record = reader->data + reader->start;
+        if(dictionary_journal_crc(record, length + 2) != record[length + 2]) break;
+
+        memcpy(word, record + 2, length);
+        word[length] = '\0';
+        callback(type, word, context);
+        reader->start += length + 3;
+        offset += length + 3;
+        journal->record_count++;
+    }
+    free(reader);
+
+    // Start over if the header is unreadable, drop a torn last record
+    bool ok = true;
+    if(offset == 0) {
+        if(size > 0) {
+            FURI_LOG_W(TAG, "%s is not a journal, starting over", journal->path);
+        }
+        ok = storage_file_seek(journal->file, 0, true) && storage_file_truncate(journal->file) &&
+             dictionary_journal_write_header(journal->file) && storage_file_sync(journal->file);
+    } else if(offset < size) {
+        FURI_LOG_W(TAG, "Dropping %lu bytes of a torn record", (unsigned long)(size - offset));
+        ok = storage_file_seek(journal->file, offset, true) && storage_file_truncate(journal->file) &&
+             storage_file_sync(journal->file);
+    } else {
+        ok = storage_file_seek(journal->file, offset, true);
+    }
+    return ok;
+}
+
+// Open the journal file for appending, unless it is open already
+static bool dictionary_journal_reopen(DictionaryJournal* journal) {
+    if(journal->file_open) return true;
+
+    if(!storage_file_open(journal->file, journal->path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Can't reopen %s", journal->path);
+        return false;
+    }
+    if(!storage_file_seek(journal->file, storage_file_size(journal->file), true)) {
+        FURI_LOG_E(TAG, "Can't seek %s", journal->path);
+        storage_file_close(journal->file);
+        return false;
+    }
+    journal->file_open = true;
+    return true;
+}
+
+// Copy a file to a new one. On failure the copy is removed.
+static bool dictionary_journal_copy(Storage* storage, const char* from, const char* to) {
+    File* source = storage_file_alloc(storage);
+    File* target = storage_file_alloc(storage);
+    bool ok = storage_file_open(source, from, FSAM_READ, FSOM_OPEN_EXISTING);
+    if(ok) {
+        ok = storage_file_open(target, to, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+        uint8_t buffer[DICTIONARY_JOURNAL_BUFFER_SIZE];
+        size_t read;
+        while(ok && (read = storage_file_read(source, buffer, sizeof(buffer))) > 0) {
+            ok = storage_file_write(target, buffer, read) == read;
+        }
+        ok = ok && storage_file_sync(target);
+        storage_file_close(target);
+        storage_file_close(source);
+    }
+    storage_file_free(target);
+    storage_file_free(source);
+    if(!ok) {
+        storage_common_remove(storage, to);
+    }
+    return ok;
+}
+
+// Open the journal and replay its records
+DictionaryJournal* dictionary_journal_open(
+    Storage* storage,
+    const char* path,
+    DictionaryJournalReplayCallback callback,
+    void* context) {
+    DictionaryJournal* journal = malloc(sizeof(DictionaryJournal));
+    journal->storage = storage;
+    journal->file_open = false;
+    journal->torn = false;
+    journal->rename_failed = false;
+    journal->record_count = 0;
+    snprintf(journal->path, sizeof(journal->path), "%s", path);
+    snprintf(journal->temporary_path, sizeof(journal->temporary_path), "%s.tmp", path);
+
+    // A compaction that stopped after removing the old journal left the new
+    // one complete; one that stopped earlier left the old journal in place
+    if(storage_common_exists(storage, journal->temporary_path)) {
+        if(storage_common_exists(storage, journal->path)) {
+            storage_common_remove(storage, journal->temporary_path);
+        } else {
+            storage_common_rename(storage, journal->temporary_path, journal->path);
+        }
+    }
+
+    journal->file = storage_file_alloc(storage);
+    if(!storage_file_open(journal->file, journal->path, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS) ||
+       !dictionary_journal_replay(journal, callback, context)) {
+        FURI_LOG_E(TAG, "Can't open %s", journal->path);
+        storage_file_free(journal->file);
+        free(journal);
+        return NULL;
+    }
+    journal->file_open = true;
+    FURI_LOG_I(TAG, "Replayed %lu records from %s", (unsigned long)journal->record_count, journal->path);
+    return journal;
+}
+
+// Close the journal
+void dictionary_journal_close(DictionaryJournal* journal) {
+    if(journal->file_open) {
+        storage_file_close(journal->file);
+    }
+    storage_file_free(journal->file);
+    free(journal);
+}
+
+// Append a record and sync it to storage
+bool dictionary_journal_append(DictionaryJournal* journal, DictionaryJournalRecordType type, const char* word) {
+    // Records behind a torn one would be lost to the replay
+    if(journal->torn || !dictionary_journal_reopen(journal)) return false;
+
+    if(!dictionary_journal_write_record(journal->file, type, word) || !storage_file_sync(journal->file)) {
+        FURI_LOG_E(TAG, "Can't append to %s", journal->path);
+        journal->torn = true;
+        return false;
+    }
+    journal->record_count++;
+    return true;
+}
+
+// Get the number of records in the journal
+uint32_t dictionary_journal_get_record_count(DictionaryJournal* journal) {
+    return journal->record_count;
+}
+
+// Replace the journal with the records of the current state
+bool dictionary_journal_rewrite(DictionaryJournal* journal, DictionaryJournalStateCallback callback, void* context) {
+    // Write the new journal aside first, the old one stays valid meanwhile
+    File* file = storage_file_alloc(journal->storage);
+    bool ok = storage_file_open(file, journal->temporary_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+              dictionary_journal_write_header(file);
+    uint32_t count = 0;
+    DictionaryJournalRecordType type;
+    const char* word;
+    while(ok && callback(&type, &word, context)) {
+        ok = dictionary_journal_write_record(file, type, word);
+        count++;
+    }
+    ok = ok && storage_file_sync(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!ok) {
+        FURI_LOG_E(TAG, "Can't write %s", journal->temporary_path);
+        storage_common_remove(journal->storage, journal->temporary_path);
+        return false;
+    }
+
+    // The device can't rename over a file, so the old journal goes first
+    if(journal->file_open) {
+        storage_file_close(journal->file);
+        journal->file_open = false;
+    }
+    storage_common_remove(journal->storage, journal->path);
+    if(storage_common_rename(journal->storage, journal->temporary_path, journal->path) != FSE_OK) {
+        // Copy the new journal into place instead, and leave compacting
+        // until the next start. Should the copy fail too, that start renames
+        // the new journal.
+        FURI_LOG_E(TAG, "Can't rename %s", journal->temporary_path);
+        journal->rename_failed = true;
+        if(!dictionary_journal_copy(journal->storage, journal->temporary_path, journal->path)) {
+            FURI_LOG_E(TAG, "Can't copy %s", journal->temporary_path);
+            return false;
+        }
+        storage_common_remove(journal->storage, journal->temporary_path);
+    }
+
+    FURI_LOG_I(TAG, "Rewrote %lu records as %lu", (unsigned long)journal->record_count, (unsigned long)count);
+    journal->record_count = count;
+    journal->torn = false;
+    return dictionary_journal_reopen(journal);
+}
+
+// Rewrite the journal once it holds far more records than the state
+bool dictionary_journal_compact(
+    DictionaryJournal* journal,
+    uint32_t state_count,
+    DictionaryJournalStateCallback callback,
+    void* context) {
+    if(journal->rename_failed || journal->record_count <= 2 * state_count + DICTIONARY_JOURNAL_SLACK) return true;
+    return dictionary_journal_rewrite(journal, callback, context);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "storage/storage.h"
+
+// Append-only journal of user data (favorites and recent lookups).
+//
+// Every change is one small record appended to the file and synced, so a
+// toggle never rewrites the file. Opening the journal replays the records
+// in order; a record cut short by a crash or power loss ends the replay and
+// is cut off the file. Once the journal holds far more records than the
+// state they add up to, it is compacted: the current state is written to a
+// temporary file which then replaces the journal.
+//
+// After a failed append the journal refuses further appends, which the
+// replay would lose behind the torn record, until a rewrite succeeds. A
+// rewrite whose rename fails copies the new journal into place instead and
+// turns compaction off until the next start.
+//
+// Records name words rather than word indices, so user data survives a
+// change of dictionary.
+
+// Kinds of records
+typedef enum {
+    DictionaryJournalFavoriteAdd = 1,
+    DictionaryJournalFavoriteRemove = 2,
+    DictionaryJournalLookup = 3,
+} DictionaryJournalRecordType;
+
+typedef struct DictionaryJournal DictionaryJournal;
+
+// Called for each record replayed from storage
+typedef void (*DictionaryJournalReplayCallback)(DictionaryJournalRecordType type, const char* word, void* context);
+
+// Called for each record of the state when compacting. Sets *type and *word
+// and returns true, or returns false after the last record.
+typedef bool (*DictionaryJournalStateCallback)(DictionaryJournalRecordType* type, const char** word, void* context);
+
+// Open the journal at path, creating it if needed, and replay its records.
+// Returns NULL if the file can't be opened.
+DictionaryJournal* dictionary_journal_open(
+    Storage* storage,
+    const char* path,
+    DictionaryJournalReplayCallback callback,
+    void* context);
+
+// Close the journal
+void dictionary_journal_close(DictionaryJournal* journal);
+
+// Append a record and sync it to storage. Returns false if it failed, or
+// if an earlier append failed and the journal was not rewritten since.
+bool dictionary_journal_append(DictionaryJournal* journal, DictionaryJournalRecordType type, const char* word);
+
+// Get the number of records in the journal
+uint32_t dictionary_journal_get_record_count(DictionaryJournal* journal);
+
+// Replace the journal with the records of the current state. Returns false
+// if it could not be rewritten.
+bool dictionary_journal_rewrite(DictionaryJournal* journal, DictionaryJournalStateCallback callback, void* context);
+
+// Rewrite the journal if it holds more than twice as many records as the
+// state plus some slack, unless a rename failed since it was opened. Returns
+// false if the journal could not be rewritten, it then keeps its records.
+bool dictionary_journal_compact(
+    DictionaryJournal* journal,
+    uint32_t state_count,
+    DictionaryJournalStateCallback callback,
+    void* context);
@@ -0,0 +1,175 @@
+#include "dictionary_layout.h"
+#include "dictionary_data.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Texts kept wrapped, enough for the definition and translation of the
+// entry shown
+#define DICTIONARY_LAYOUT_SLOTS 2
+
+typedef struct {
+    uint32_t index;
+    bool translation;
+    uint32_t last_used; // 0 for an empty slot
+    DictionaryLayoutText wrapped;
+} DictionaryLayoutSlot;
+
+struct DictionaryLayout {
+    uint32_t tick;
+    DictionaryLayoutSlot slots[DICTIONARY_LAYOUT_SLOTS];
+};
+
+// Get the width of the UTF-8 character at *text and move past it
+static uint8_t dictionary_layout_next_char(DictionaryGlyphsFont font, const char** text) {
+    const uint8_t* bytes = (const uint8_t*)*text;
+    uint32_t code = bytes[0];
+    uint8_t size = 1;
+    if(code >= 0xf0) {
+        code &= 0x07;
+        size = 4;
+    } else if(code >= 0xe0) {
+        code &= 0x0f;
+        size = 3;
+    } else if(code >= 0xc0) {
+        code &= 0x1f;
+        size = 2;
+    }
+
+    // A broken sequence ends at the first byte that does not continue it
+    uint8_t length = 1;
+    while(length < size && (bytes[length] & 0xc0) == 0x80) {
+        code = (code << 6) | (bytes[length] & 0x3f);
+        length++;
+    }
+    while((bytes[length] & 0xc0) == 0x80) {
+        length++;
+    }
+    *text += length;
+    return dictionary_glyphs_widths[font][dictionary_glyphs_get_slot(code)];
+}
+
+// Get the width of a text drawn in a font
+uint32_t dictionary_layout_get_width(DictionaryGlyphsFont font, const char* text) {
+    uint32_t width = 0;
+    while(*text != '\0') {
+        width += dictionary_layout_next_char(font, &text);
+    }
+    return width;
+}
+
+// Get the bytes of the start of a text that fits in a width
+size_t dictionary_layout_fit(DictionaryGlyphsFont font, const char* text, uint32_t width) {
+    const char* end = text;
+    uint32_t used = 0;
+    while(*end != '\0') {
+        const char* next = end;
+        used += dictionary_layout_next_char(font, &next);
+        if(used > width) break;
+        end = next;
+    }
+    return end - text;
+}
+
+// Copy a text cut to fit a width
+bool dictionary_layout_cut(DictionaryGlyphsFont font, const char* text, uint32_t width, char* out, size_t size) {
+    size_t length = dictionary_layout_fit(font, text, width);
+    bool whole = text[length] == '\0';
+    if(!whole) {
+        uint32_t dots = dictionary_layout_get_width(font, "...");
+        length = dictionary_layout_fit(font, text, width > dots ? width - dots : 0);
+    }
+
+    // A cut that does not fit out ends at a character boundary
+    size_t room = whole ? size - 1 : size - 4;
+    if(length > room) {
+        length = room;
+        while(length > 0 && (text[length] & 0xc0) == 0x80) {
+            length--;
+        }
+    }
+    memcpy(out, text, length);
+    strcpy(out + length, whole ? "" : "...");
+    return whole;
+}
+
+// Wrap a text into lines of at most DICTIONARY_LAYOUT_WIDTH pixels
+static void dictionary_layout_wrap(DictionaryLayoutText* wrapped, const char* text) {
+    uint16_t size = 0;
+    wrapped->line_count = 0;
+    while(*text != '\0' && wrapped->line_count < DICTIONARY_LAYOUT_LINES_MAX) {
+        // Take as many whole characters as fit, at least one, noting the
+        // last space
+        const char* end = text;
+        const char* space = NULL;
+        uint32_t width = 0;
+        while(*end != '\0') {
+            if(*end == ' ') space = end;
+            const char* next = end;
+            width += dictionary_layout_next_char(DictionaryGlyphsFontSecondary, &next);
+            if(width > DICTIONARY_LAYOUT_WIDTH && end > text) break;
+            end = next;
+        }
+
+        // Break at a space if there is one, cutting a word only if it fills
+        // the whole line
+        const char* next = end;
+        if(*end == ' ') {
+            next = end + 1;
+        } else if(*end != '\0' && space != NULL && space > text) {
+            end = space;
+            next = space + 1;
+        }
+
+        wrapped->lines[wrapped->line_count++] = size;
+        memcpy(wrapped->text + size, text, end - text);
+        size += end - text;
+        wrapped->text[size++] = '\0';
+        text = next;
+    }
+
+    // An empty text still shows as one empty line
+    if(wrapped->line_count == 0) {
+        wrapped->lines[wrapped->line_count++] = 0;
+        wrapped->text[0] = '\0';
+    }
+}
+
+// Allocate an empty cache
+DictionaryLayout* dictionary_layout_alloc(void) {
+    DictionaryLayout* layout = malloc(sizeof(DictionaryLayout));
+    memset(layout, 0, sizeof(DictionaryLayout));
+    return layout;
+}
+
+// Free the cache
+void dictionary_layout_free(DictionaryLayout* layout) {
+    free(layout);
+}
+
+// Get the wrapped text of an entry, wrapping it on a miss
+const DictionaryLayoutText* dictionary_layout_get(DictionaryLayout* layout, uint32_t index, bool translation) {
+    layout->tick++;
+
+    DictionaryLayoutSlot* slot = &layout->slots[0];
+    for(uint8_t i = 0; i < DICTIONARY_LAYOUT_SLOTS; i++) {
+        DictionaryLayoutSlot* candidate = &layout->slots[i];
+        if(candidate->last_used != 0 && candidate->index == index && candidate->translation == translation) {
+            candidate->last_used = layout->tick;
+            return &candidate->wrapped;
+        }
+        if(candidate->last_used < slot->last_used) {
+            slot = candidate;
+        }
+    }
+
+    // Replace the least recently used text
+    const char* text = translation ? dictionary_data_get_translation_by_index(index) :
+                                     dictionary_data_get_definition_by_index(index);
+    dictionary_layout_wrap(&slot->wrapped, text);
+    slot->index = index;
+    slot->translation = translation;
+    slot->last_used = layout->tick;
+    return &slot->wrapped;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "dictionary_format.h"
+#include "dictionary_glyphs.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Line breaks of definitions and translations for the word view.
+//
+// A text is wrapped once, the first time its entry is shown in a mode, into a
+// copy of the text with every line NUL-terminated and a table of where the
+// lines start. Drawing and scrolling then read the table and never scan the
+// text again. Lines are as wide as the glyphs of FontSecondary allow and
+// break after whole UTF-8 characters only, preferably at a space, which the
+// break drops. The last few texts shown stay wrapped, so toggling between
+// definition and translation costs nothing.
+
+// Pixels of a line of the word view
+#define DICTIONARY_LAYOUT_WIDTH 124
+
+// Most lines of a text. A line and the first word of the next one are wider
+// than DICTIONARY_LAYOUT_WIDTH, which takes at least 18 characters of at most
+// 7 pixels, so the longest text needs fewer.
+#define DICTIONARY_LAYOUT_LINES_MAX 128
+
+// A wrapped text
+typedef struct {
+    uint16_t line_count;
+    uint16_t lines[DICTIONARY_LAYOUT_LINES_MAX]; // Offset of each line in text
+    char text[DICTIONARY_TEXT_MAX + DICTIONARY_LAYOUT_LINES_MAX + 1];
+} DictionaryLayoutText;
+
+typedef struct DictionaryLayout DictionaryLayout;
+
+// Allocate an empty cache
+DictionaryLayout* dictionary_layout_alloc(void);
+
+// Free the cache
+void dictionary_layout_free(DictionaryLayout* layout);
+
+// Get the definition or translation of an entry wrapped into lines, wrapping
+// it if it is not cached. The result stays valid until the next call.
+const DictionaryLayoutText* dictionary_layout_get(DictionaryLayout* layout, uint32_t index, bool translation);
+
+// Get a line of a wrapped text
+#define dictionary_layout_get_line(wrapped, line) ((wrapped)->text + (wrapped)->lines[line])
+
+// Get the width in pixels of a text drawn in a font
+uint32_t dictionary_layout_get_width(DictionaryGlyphsFont font, const char* text);
+
+// Get the number of bytes of the longest start of a text, in whole
+// characters, that fits in width pixels
+size_t dictionary_layout_fit(DictionaryGlyphsFont font, const char* text, uint32_t width);
+
+// Copy a text to out, cut to fit in width pixels and ending in "..." if it
+// was cut. out must hold size bytes, at least 4. Returns false if the text
+// was cut.
+bool dictionary_layout_cut(DictionaryGlyphsFont font, const char* text, uint32_t width, char* out, size_t size);
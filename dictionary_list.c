@@ -0,0 +1,123 @@
+#include "dictionary_list.h"
+#include "dictionary_data.h"
+#include "dictionary_layout.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "furi.h"
+
+// Left of the star and of the word with and without one
+#define DICTIONARY_LIST_STAR_X 5
+#define DICTIONARY_LIST_WORD_X 5
+#define DICTIONARY_LIST_STARRED_X 17
+
+#define DICTIONARY_LIST_ROW_HEIGHT 10
+
+// A word drawn by the last frame
+typedef struct {
+    uint32_t index;  // Word index, UINT32_MAX for an unused row
+    bool starred;    // Cut for the room left by a star
+    char text[DICTIONARY_WORD_MAX + 4];
+} DictionaryListRow;
+
+struct DictionaryList {
+    DictionaryListStyle style;
+    DictionaryListRow rows[DICTIONARY_LIST_ROWS_MAX];
+};
+
+// Allocate a list
+DictionaryList* dictionary_list_alloc(const DictionaryListStyle* style) {
+    DictionaryList* list = malloc(sizeof(DictionaryList));
+    list->style = *style;
+    if(list->style.rows > DICTIONARY_LIST_ROWS_MAX) {
+        list->style.rows = DICTIONARY_LIST_ROWS_MAX;
+    }
+    for(uint8_t i = 0; i < DICTIONARY_LIST_ROWS_MAX; i++) {
+        list->rows[i].index = UINT32_MAX;
+    }
+    return list;
+}
+
+// Free the list
+void dictionary_list_free(DictionaryList* list) {
+    free(list);
+}
+
+// Draw the visible rows
+void dictionary_list_draw(
+    DictionaryList* list,
+    Canvas* canvas,
+    uint32_t selected,
+    uint32_t count,
+    DictionaryListRowCallback row,
+    void* context,
+    DictionaryFavorites* favorites) {
+    const DictionaryListStyle* style = &list->style;
+    uint32_t first = selected > style->lead ? selected - style->lead : 0;
+    uint8_t visible = 0;
+    while(visible < style->rows && first + visible < count) {
+        visible++;
+    }
+
+    // Keep the rows whose word is still shown, wherever it moved to
+    DictionaryListRow rows[DICTIONARY_LIST_ROWS_MAX];
+    uint32_t missing[DICTIONARY_LIST_ROWS_MAX];
+    uint8_t missing_rows[DICTIONARY_LIST_ROWS_MAX];
+    uint8_t missing_count = 0;
+    for(uint8_t i = 0; i < visible; i++) {
+        uint32_t index = row(first + i, context);
+        bool starred = favorites != NULL && dictionary_favorites_contains(favorites, index);
+        uint8_t cached = 0;
+        while(cached < DICTIONARY_LIST_ROWS_MAX &&
+              (list->rows[cached].index != index || list->rows[cached].starred != starred)) {
+            cached++;
+        }
+        if(cached < DICTIONARY_LIST_ROWS_MAX) {
+            rows[i] = list->rows[cached];
+        } else {
+            rows[i].index = index;
+            rows[i].starred = starred;
+            missing[missing_count] = index;
+            missing_rows[missing_count++] = i;
+        }
+    }
+
+    // Fetch the new words in one call and cut them to the row
+    if(missing_count > 0) {
+        char words[DICTIONARY_LIST_ROWS_MAX][DICTIONARY_WORD_MAX + 1];
+        dictionary_data_get_words(missing, missing_count, words);
+        for(uint8_t i = 0; i < missing_count; i++) {
+            DictionaryListRow* fetched = &rows[missing_rows[i]];
+            int32_t x = fetched->starred ? DICTIONARY_LIST_STARRED_X : DICTIONARY_LIST_WORD_X;
+            dictionary_layout_cut(
+                DictionaryGlyphsFontPrimary,
+                words[i],
+                style->width - 2 - x,
+                fetched->text,
+                sizeof(fetched->text));
+        }
+    }
+    for(uint8_t i = visible; i < DICTIONARY_LIST_ROWS_MAX; i++) {
+        rows[i].index = UINT32_MAX;
+    }
+    memcpy(list->rows, rows, sizeof(rows));
+
+    canvas_set_font(canvas, FontPrimary);
+    for(uint8_t i = 0; i < visible; i++) {
+        int32_t y = style->top + i * DICTIONARY_LIST_ROW_HEIGHT;
+        if(first + i == selected) {
+            canvas_draw_frame(canvas, 0, y, style->width, DICTIONARY_LIST_ROW_HEIGHT + 2);
+        }
+        if(rows[i].starred) {
+            canvas_draw_str(canvas, DICTIONARY_LIST_STAR_X, y + DICTIONARY_LIST_ROW_HEIGHT, "★ ");
+            canvas_draw_str(canvas, DICTIONARY_LIST_STARRED_X, y + DICTIONARY_LIST_ROW_HEIGHT, rows[i].text);
+        } else {
+            canvas_draw_str(canvas, DICTIONARY_LIST_WORD_X, y + DICTIONARY_LIST_ROW_HEIGHT, rows[i].text);
+        }
+    }
+
+    if(style->scrollbar) {
+        elements_scrollbar_pos(
+            canvas, 128, style->top, style->rows * DICTIONARY_LIST_ROW_HEIGHT - 8, selected, count);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "dictionary_favorites.h"
+#include "dictionary_format.h"
+#include "gui/elements.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Scrolling list of words shared by the main, favorites and search results
+// views.
+//
+// Only the visible rows are ever looked at. The row callback maps each of
+// them to a word index, then the words the list does not hold yet are fetched
+// from the data layer in one batch. Rows keep their word, already cut to the
+// row width, between frames, so moving by one row fetches one word however
+// long the list is.
+
+// Most rows a list shows at once
+#define DICTIONARY_LIST_ROWS_MAX 5
+
+// Look of a list
+typedef struct {
+    int32_t top;      // Top of the first row
+    uint8_t rows;     // Rows shown, at most DICTIONARY_LIST_ROWS_MAX
+    uint8_t lead;     // Rows kept above the selection
+    int32_t width;    // Width of the selection frame
+    bool scrollbar;   // Show the position right of the rows
+} DictionaryListStyle;
+
+// Get the word index of a list position
+typedef uint32_t (*DictionaryListRowCallback)(uint32_t position, void* context);
+
+typedef struct DictionaryList DictionaryList;
+
+// Allocate a list with an empty row cache
+DictionaryList* dictionary_list_alloc(const DictionaryListStyle* style);
+
+// Free the list
+void dictionary_list_free(DictionaryList* list);
+
+// Draw the rows around the selected position of count positions in
+// FontPrimary. Favorites, if not NULL, get a star.
+void dictionary_list_draw(
+    DictionaryList* list,
+    Canvas* canvas,
+    uint32_t selected,
+    uint32_t count,
+    DictionaryListRowCallback row,
+    void* context,
+    DictionaryFavorites* favorites);
@@ -0,0 +1,219 @@
+#include "dictionary_profile.h"
+
+#if DICTIONARY_PROFILE
+
+#include "dictionary_data.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "furi.h"
+
+#define TAG "DictionaryProfile"
+
+// Lines of the summary ahead of the timers
+#define DICTIONARY_PROFILE_COUNTER_LINES 6
+
+// Longest line written to the file
+#define DICTIONARY_PROFILE_LINE_MAX 96
+
+DictionaryProfileCounters dictionary_profile_counters;
+
+static DictionaryProfileTimer timers[DictionaryProfileCount];
+
+// Block cache counters of the data layer at the last reset
+static DictionaryDataStats baseline;
+
+// Short names, to fit the screen
+static const char* const operation_names[DictionaryProfileCount] = {
+    [DictionaryProfileLookup] = "Lookup",
+    [DictionaryProfileWord] = "Word",
+    [DictionaryProfileText] = "Text",
+    [DictionaryProfilePrefix] = "Prefix",
+    [DictionaryProfileTranslation] = "Russian",
+    [DictionaryProfileSearch] = "Search",
+    [DictionaryProfileJump] = "Jump",
+    [DictionaryProfilePrefetch] = "Prefetch",
+    [DictionaryProfileEvent] = "Event",
+    [DictionaryProfileDraw] = "Draw",
+};
+
+// Record the time of an operation
+void dictionary_profile_record(DictionaryProfileOperation operation, uint32_t cycles) {
+    DictionaryProfileTimer* timer = &timers[operation];
+    timer->count++;
+    timer->cycles += cycles;
+    if(cycles > timer->max_cycles) {
+        timer->max_cycles = cycles;
+    }
+
+    // Bucket by the bit length of the time, so each bucket doubles the last
+    int32_t bucket = cycles > 0 ? 32 - __builtin_clz(cycles) - DICTIONARY_PROFILE_BUCKET_SHIFT : 0;
+    if(bucket < 0) {
+        bucket = 0;
+    } else if(bucket >= DICTIONARY_PROFILE_BUCKETS) {
+        bucket = DICTIONARY_PROFILE_BUCKETS - 1;
+    }
+    timer->buckets[bucket]++;
+}
+
+// Record the time of a scope leaving
+void dictionary_profile_end(DictionaryProfileScope* scope) {
+    dictionary_profile_record(scope->operation, DWT->CYCCNT - scope->start);
+}
+
+// Clear the counters and timers
+void dictionary_profile_reset(void) {
+    memset(&dictionary_profile_counters, 0, sizeof(dictionary_profile_counters));
+    memset(timers, 0, sizeof(timers));
+    dictionary_data_get_stats(&baseline);
+}
+
+// Get the number of summary lines
+uint32_t dictionary_profile_get_line_count(void) {
+    return DICTIONARY_PROFILE_COUNTER_LINES + DictionaryProfileCount;
+}
+
+// Get a hit rate in percent, all hits when there was nothing to miss
+static unsigned long dictionary_profile_percent(uint32_t hits, uint32_t total) {
+    return total > 0 ? (uint64_t)hits * 100 / total : 100;
+}
+
+// Convert cycles to microseconds
+static unsigned long dictionary_profile_us(uint64_t cycles) {
+    return cycles / furi_hal_cortex_instructions_per_microsecond();
+}
+
+// Format a summary line, short enough for the screen
+void dictionary_profile_format_line(uint32_t line, char* out, size_t size) {
+    const DictionaryProfileCounters* counters = &dictionary_profile_counters;
+    DictionaryDataStats stats;
+    dictionary_data_get_stats(&stats);
+
+    switch(line) {
+    case 0:
+        snprintf(
+            out,
+            size,
+            "Read %lu pages, %lu KB",
+            (unsigned long)counters->storage_reads,
+            (unsigned long)(counters->storage_bytes / 1024));
+        return;
+    case 1:
+        snprintf(
+            out,
+            size,
+            "Pages %lu%% of %lu",
+            dictionary_profile_percent(counters->page_hits, counters->page_lookups),
+            (unsigned long)counters->page_lookups);
+        return;
+    case 2:
+        snprintf(
+            out,
+            size,
+            "Words %lu%% of %lu",
+            dictionary_profile_percent(counters->word_hits, counters->word_lookups),
+            (unsigned long)counters->word_lookups);
+        return;
+    case 3:
+        snprintf(
+            out,
+            size,
+            "Texts %lu%% of %lu",
+            dictionary_profile_percent(
+                stats.text_cache_hits - baseline.text_cache_hits, stats.text_lookups - baseline.text_lookups),
+            (unsigned long)(stats.text_lookups - baseline.text_lookups));
+        return;
+    case 4:
+        snprintf(
+            out,
+            size,
+            "Decoded %lu, %lu KB",
+            (unsigned long)(stats.blocks_decoded - baseline.blocks_decoded),
+            (unsigned long)((stats.bytes_decoded - baseline.bytes_decoded) / 1024));
+        return;
+    case 5:
+        snprintf(
+            out,
+            size,
+            "Prefetched %lu, used %lu/%lu",
+            (unsigned long)(stats.prefetch_reads - baseline.prefetch_reads),
+            (unsigned long)(stats.prefetch_hits - baseline.prefetch_hits),
+            (unsigned long)(stats.prefetch_hits - baseline.prefetch_hits + stats.prefetch_misses -
+                            baseline.prefetch_misses));
+        return;
+    default:
+        break;
+    }
+
+    // A timer: how often, the mean and the longest time in microseconds
+    uint32_t operation = line - DICTIONARY_PROFILE_COUNTER_LINES;
+    if(operation >= DictionaryProfileCount) {
+        out[0] = '\0';
+        return;
+    }
+    const DictionaryProfileTimer* timer = &timers[operation];
+    snprintf(
+        out,
+        size,
+        "%s %lu: %lu, max %lu us",
+        operation_names[operation],
+        (unsigned long)timer->count,
+        timer->count > 0 ? dictionary_profile_us(timer->cycles / timer->count) : 0,
+        dictionary_profile_us(timer->max_cycles));
+}
+
+// Write a line to the file. Returns false on failure.
+static bool dictionary_profile_write(File* file, const char* line) {
+    size_t length = strlen(line);
+    return storage_file_write(file, line, length) == length;
+}
+
+// Write the summary and the histograms to a text file. Returns false on failure.
+bool dictionary_profile_save(Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to create %s", path);
+        storage_file_free(file);
+        return false;
+    }
+
+    bool ok = true;
+    char line[DICTIONARY_PROFILE_LINE_MAX];
+    for(uint32_t i = 0; ok && i < dictionary_profile_get_line_count(); i++) {
+        dictionary_profile_format_line(i, line, sizeof(line) - 1);
+        strcat(line, "\n");
+        ok = dictionary_profile_write(file, line);
+    }
+
+    // Each bucket counts the times under its bound, the last one those over
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    ok = ok && dictionary_profile_write(file, "\nTimes under, us:");
+    for(uint32_t bucket = 0; ok && bucket < DICTIONARY_PROFILE_BUCKETS - 1; bucket++) {
+        snprintf(
+            line,
+            sizeof(line),
+            " %lu",
+            (unsigned long)((1ul << (bucket + DICTIONARY_PROFILE_BUCKET_SHIFT)) / cycles_per_us));
+        ok = dictionary_profile_write(file, line);
+    }
+    ok = ok && dictionary_profile_write(file, " over\n");
+    for(uint32_t operation = 0; ok && operation < DictionaryProfileCount; operation++) {
+        snprintf(line, sizeof(line), "%-8s", operation_names[operation]);
+        ok = dictionary_profile_write(file, line);
+        for(uint32_t bucket = 0; ok && bucket < DICTIONARY_PROFILE_BUCKETS; bucket++) {
+            snprintf(line, sizeof(line), " %lu", (unsigned long)timers[operation].buckets[bucket]);
+            ok = dictionary_profile_write(file, line);
+        }
+        ok = ok && dictionary_profile_write(file, "\n");
+    }
+
+    ok = ok && storage_file_sync(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!ok) {
+        FURI_LOG_E(TAG, "Failed to save %s", path);
+    }
+    return ok;
+}
+
+#endif
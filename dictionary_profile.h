@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Counters and timings for finding where time goes on the device.
+//
+// Built with DICTIONARY_PROFILE set to 1 (`make PROFILE=1`), the data layer
+// counts its storage reads and cache hits and times its lookups, and the app
+// times each batch of input and each frame, in CPU cycles of the DWT cycle
+// counter. Every time also lands in a histogram of power-of-two buckets.
+// Right in the word view opens a hidden view of the numbers, which can save
+// them to a file. Built without it, every macro below expands to nothing and
+// none of the code exists.
+//
+// Times include those of the calls they make. Everything is recorded and read
+// with the app's mutex held.
+
+#ifndef DICTIONARY_PROFILE
+#define DICTIONARY_PROFILE 0
+#endif
+
+#if DICTIONARY_PROFILE
+
+#include "furi_hal.h"
+#include "storage/storage.h"
+
+// Timed operations
+typedef enum {
+    DictionaryProfileLookup,      // Exact word lookups
+    DictionaryProfileWord,        // Words by index, one or a list page at a time
+    DictionaryProfileText,        // Definitions and translations
+    DictionaryProfilePrefix,      // Prefix ranges and letters
+    DictionaryProfileTranslation, // Russian ranges and letters
+    DictionaryProfileSearch,      // Worker queries, with the pauses letting the app run
+    DictionaryProfileJump,        // Letter jumps in the main list
+    DictionaryProfilePrefetch,    // Reading ahead while scrolling
+    DictionaryProfileEvent,       // A batch of input events
+    DictionaryProfileDraw,        // A frame
+    DictionaryProfileCount,
+} DictionaryProfileOperation;
+
+// Histogram buckets: bucket b counts the times under 2^(b + 7) cycles, about
+// 2^(b + 1) us on the device, and the last one all longer times
+#define DICTIONARY_PROFILE_BUCKETS 16
+#define DICTIONARY_PROFILE_BUCKET_SHIFT 7
+
+typedef struct {
+    uint32_t count;
+    uint64_t cycles;
+    uint32_t max_cycles;
+    uint32_t buckets[DICTIONARY_PROFILE_BUCKETS];
+} DictionaryProfileTimer;
+
+// Counters the data layer keeps only while profiling
+typedef struct {
+    uint32_t storage_reads; // Pages read from the dictionary file
+    uint32_t storage_bytes;
+    uint32_t page_lookups; // Pages requested from the file's page cache
+    uint32_t page_hits;
+    uint32_t word_lookups; // Word blocks requested from the word block cache
+    uint32_t word_hits;
+} DictionaryProfileCounters;
+
+extern DictionaryProfileCounters dictionary_profile_counters;
+
+// A timed scope, ended by dictionary_profile_end() as it goes out of scope
+typedef struct {
+    DictionaryProfileOperation operation;
+    uint32_t start;
+} DictionaryProfileScope;
+
+// Record the time of an operation
+void dictionary_profile_record(DictionaryProfileOperation operation, uint32_t cycles);
+
+// Record the time of a scope leaving
+void dictionary_profile_end(DictionaryProfileScope* scope);
+
+// Clear the counters and timers
+void dictionary_profile_reset(void);
+
+// Get the number of summary lines
+uint32_t dictionary_profile_get_line_count(void);
+
+// Format a summary line, short enough for the screen
+void dictionary_profile_format_line(uint32_t line, char* out, size_t size);
+
+// Write the summary and the histograms to a text file. Returns false on failure.
+bool dictionary_profile_save(Storage* storage, const char* path);
+
+// Time the rest of the enclosing block
+#define DICTIONARY_PROFILE_SCOPE(operation)                                          \
+    DictionaryProfileScope dictionary_profile_scope                                  \
+        __attribute__((cleanup(dictionary_profile_end))) = {(operation), DWT->CYCCNT}
+
+// Time a stretch of code that is not a block of its own
+#define DICTIONARY_PROFILE_BEGIN(name) uint32_t name = DWT->CYCCNT
+#define DICTIONARY_PROFILE_END(operation, name) \
+    dictionary_profile_record((operation), DWT->CYCCNT - (name))
+
+// Add to a counter of DictionaryProfileCounters
+#define DICTIONARY_PROFILE_COUNT(counter, amount) (dictionary_profile_counters.counter += (amount))
+
+#else
+
+#define DICTIONARY_PROFILE_SCOPE(operation)
+#define DICTIONARY_PROFILE_BEGIN(name)
+#define DICTIONARY_PROFILE_END(operation, name)
+#define DICTIONARY_PROFILE_COUNT(counter, amount)
+
+#endif
@@ -0,0 +1,159 @@
+#include "dictionary_ranks.h"
+#include "dictionary_format.h"
+
+#include <stdlib.h>
+#include "furi.h"
+
+// Nodes of one tier below a node of the tier above it, read together
+typedef struct {
+    uint8_t tier;
+    uint32_t first; // Node index of values[0] within its tier
+    uint8_t count;
+    uint8_t next;
+    uint8_t values[DICTIONARY_RANK_FANOUT];
+} DictionaryRanksFrame;
+
+struct DictionaryRanks {
+    DictionaryFile* file;
+    uint32_t entry_count;
+    uint8_t tier_count;
+    uint32_t tier_base[DICTIONARY_RANK_TIERS_MAX];
+    uint32_t tier_length[DICTIONARY_RANK_TIERS_MAX];
+    uint32_t size;
+
+    DictionaryRanksFrame frames[DICTIONARY_RANK_TIERS_MAX];
+};
+
+// Add a word to the list, kept sorted by rank, when it makes the cut. Words
+// arrive in word order, so a word goes after those of the same rank.
+static uint32_t dictionary_ranks_add_word(
+    DictionaryRankedWord* words,
+    uint32_t count,
+    uint32_t max_words,
+    uint32_t index,
+    uint8_t rank) {
+    uint32_t position = count;
+    while(position > 0 && words[position - 1].rank < rank) {
+        position--;
+    }
+    if(position == max_words) return count;
+
+    if(count < max_words) {
+        count++;
+    }
+    for(uint32_t i = count - 1; i > position; i--) {
+        words[i] = words[i - 1];
+    }
+    words[position].index = index;
+    words[position].rank = rank;
+    return count;
+}
+
+// Read the nodes [first, last) of a tier into a frame
+static bool dictionary_ranks_read_frame(
+    DictionaryRanks* ranks,
+    DictionaryRanksFrame* frame,
+    uint8_t tier,
+    uint32_t first,
+    uint32_t last) {
+    frame->tier = tier;
+    frame->first = first;
+    frame->count = last - first;
+    frame->next = 0;
+    return dictionary_file_read(ranks->file, ranks->tier_base[tier] + first, frame->values, frame->count);
+}
+
+// Check the section size and set up the reader
+DictionaryRanks* dictionary_ranks_alloc(DictionaryFile* file, uint32_t entry_count, uint32_t offset, uint32_t size) {
+    DictionaryRanks* ranks = malloc(sizeof(DictionaryRanks));
+    ranks->file = file;
+    ranks->entry_count = entry_count;
+    ranks->size = size;
+
+    // Each tier holds the maximum of every DICTIONARY_RANK_FANOUT nodes of
+    // the tier below, up to a tier of a single node
+    uint32_t length = entry_count;
+    uint32_t base = offset;
+    ranks->tier_count = 0;
+    while(length > 0 && ranks->tier_count < DICTIONARY_RANK_TIERS_MAX) {
+        ranks->tier_base[ranks->tier_count] = base;
+        ranks->tier_length[ranks->tier_count] = length;
+        ranks->tier_count++;
+        base += length;
+        if(length == 1) break;
+        length = (length + DICTIONARY_RANK_FANOUT - 1) / DICTIONARY_RANK_FANOUT;
+    }
+    if(base - offset != size) {
+        free(ranks);
+        return NULL;
+    }
+    return ranks;
+}
+
+// Free the reader
+void dictionary_ranks_free(DictionaryRanks* ranks) {
+    free(ranks);
+}
+
+// Get the size of the section
+uint32_t dictionary_ranks_get_size(DictionaryRanks* ranks) {
+    return ranks->size;
+}
+
+// Find the highest ranked words in a range
+uint32_t dictionary_ranks_find_top(
+    DictionaryRanks* ranks,
+    uint32_t first,
+    uint32_t last,
+    DictionaryRankedWord* words,
+    uint32_t max_words,
+    DictionaryDataProgress progress,
+    void* context) {
+    if(ranks == NULL || first >= last || last > ranks->entry_count || max_words == 0) return 0;
+
+    // Walk down from the top tier in word order, skipping every node whose
+    // maximum can't beat the last word of a full list
+    uint32_t count = 0;
+    uint32_t steps = 0;
+    uint8_t tier = ranks->tier_count - 1;
+    uint8_t depth = 1;
+    if(!dictionary_ranks_read_frame(ranks, &ranks->frames[0], tier, 0, ranks->tier_length[tier])) return 0;
+
+    while(depth > 0) {
+        if(progress != NULL && ++steps % DICTIONARY_DATA_PROGRESS_STEPS == 0 && !progress(count, context)) break;
+
+        DictionaryRanksFrame* frame = &ranks->frames[depth - 1];
+        if(frame->next == frame->count) {
+            depth--;
+            continue;
+        }
+        uint32_t node = frame->first + frame->next;
+        uint8_t value = frame->values[frame->next++];
+        if(count == max_words && value <= words[count - 1].rank) continue;
+
+        if(frame->tier == 0) {
+            count = dictionary_ranks_add_word(words, count, max_words, node, value);
+            continue;
+        }
+
+        // Only the children that overlap the range
+        uint32_t span = 1;
+        for(uint8_t i = 1; i < frame->tier; i++) {
+            span *= DICTIONARY_RANK_FANOUT;
+        }
+        uint32_t child_first = node * DICTIONARY_RANK_FANOUT;
+        uint32_t child_last = child_first + DICTIONARY_RANK_FANOUT;
+        if(child_first < first / span) {
+            child_first = first / span;
+        }
+        if(child_last > (last - 1) / span + 1) {
+            child_last = (last - 1) / span + 1;
+        }
+        if(child_first >= child_last) continue;
+        if(!dictionary_ranks_read_frame(ranks, &ranks->frames[depth], frame->tier - 1, child_first, child_last)) {
+            break;
+        }
+        depth++;
+    }
+    return count;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "dictionary_data.h"
+#include "dictionary_file.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Reader for the ranks section described in dictionary_format.h: a frequency
+// rank per entry and the tiers of maxima above it, used to find the most
+// frequent words of a range without reading the whole range.
+
+typedef struct DictionaryRanks DictionaryRanks;
+
+// Check the section size and set up the reader, the section stays on
+// storage. Returns NULL if the size does not match entry_count.
+DictionaryRanks* dictionary_ranks_alloc(DictionaryFile* file, uint32_t entry_count, uint32_t offset, uint32_t size);
+
+// Free the reader
+void dictionary_ranks_free(DictionaryRanks* ranks);
+
+// Get the size of the section
+uint32_t dictionary_ranks_get_size(DictionaryRanks* ranks);
+
+// Find the max_words highest ranked words in [first, last), highest rank
+// first and ties in word order. Returns the number of words found.
+// Progress is reported per node visited, see DictionaryDataProgress.
+uint32_t dictionary_ranks_find_top(
+    DictionaryRanks* ranks,
+    uint32_t first,
+    uint32_t last,
+    DictionaryRankedWord* words,
+    uint32_t max_words,
+    DictionaryDataProgress progress,
+    void* context);
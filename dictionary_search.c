@@ -0,0 +1,177 @@
+#include "dictionary_search.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Queries waiting for the worker; once the queue is full all of them are
+// cancelled already
+#define DICTIONARY_SEARCH_QUEUE_SIZE 4
+
+#define DICTIONARY_SEARCH_STACK_SIZE 2048
+
+// Edits allowed between the term and a suggestion
+#define DICTIONARY_SEARCH_SUGGESTION_DISTANCE 2
+
+struct DictionarySearch {
+    FuriMutex* mutex;
+    FuriMessageQueue* queue;
+    FuriThread* thread;
+    DictionarySearchCallback callback;
+    void* context;
+
+    // Guarded by the mutex
+    uint32_t latest_id;          // Newest query submitted or cancelled
+    DictionarySearchQuery query; // Running query
+    uint32_t published;          // Results it has passed on so far
+    DictionarySearchResults results;
+    DictionaryMatch matches[DICTIONARY_SEARCH_RESULTS_MAX];
+    DictionaryRankedWord words[DICTIONARY_SEARCH_RESULTS_MAX];
+};
+
+// Pass on what the running query has found
+static void dictionary_search_publish(DictionarySearch* search, uint32_t found, bool done) {
+    DictionarySearchResults* results = &search->results;
+    results->done = done;
+    results->total = found;
+    results->count = found < search->query.max_results ? found : search->query.max_results;
+
+    // Full-text matches are written straight to the results
+    for(uint32_t i = 0; i < results->count; i++) {
+        if(results->type == DictionarySearchQueryCompletions) {
+            results->indices[i] = search->words[i].index;
+            results->scores[i] = search->words[i].rank;
+        } else if(results->type == DictionarySearchQuerySuggestions) {
+            results->indices[i] = search->matches[i].index;
+            results->scores[i] = search->matches[i].distance;
+        } else {
+            results->scores[i] = 0;
+        }
+    }
+    search->published = found;
+    search->callback(results, search->context);
+}
+
+// Pass on new results of the running query, then let the app have the data
+// before the next step. Returns false once a newer query cancelled it.
+static bool dictionary_search_progress(uint32_t found, void* context) {
+    DictionarySearch* search = context;
+    if(found != search->published) {
+        dictionary_search_publish(search, found, false);
+    }
+
+    furi_mutex_release(search->mutex);
+    furi_thread_yield();
+    furi_mutex_acquire(search->mutex, FuriWaitForever);
+    return search->query.id == search->latest_id;
+}
+
+// Run the query in search->query with the mutex held
+static void dictionary_search_run(DictionarySearch* search) {
+    DictionarySearchQuery* query = &search->query;
+    search->results.id = query->id;
+    search->results.type = query->type;
+    search->published = 0;
+
+    uint32_t found = 0;
+    switch(query->type) {
+    case DictionarySearchQueryCompletions:
+        found = dictionary_data_find_top_words(
+            &query->prefix, search->words, query->max_results, dictionary_search_progress, search);
+        break;
+    case DictionarySearchQuerySuggestions:
+        found = dictionary_data_find_similar_words(
+            query->term,
+            DICTIONARY_SEARCH_SUGGESTION_DISTANCE,
+            search->matches,
+            query->max_results,
+            dictionary_search_progress,
+            search);
+        break;
+    case DictionarySearchQueryDefinitions:
+        found = dictionary_data_find_words_with_definition(
+            query->term, search->results.indices, query->max_results, dictionary_search_progress, search);
+        break;
+    default:
+        break;
+    }
+
+    // A cancelled query stops where it is without a word more
+    if(query->id == search->latest_id) {
+        dictionary_search_publish(search, found, true);
+    }
+}
+
+// Worker thread: run the newest query until told to stop
+static int32_t dictionary_search_worker(void* context) {
+    DictionarySearch* search = context;
+    DictionarySearchQuery query;
+    while(furi_message_queue_get(search->queue, &query, FuriWaitForever) == FuriStatusOk) {
+        // Queries queued behind a newer one were cancelled by it
+        DictionarySearchQuery next;
+        while(query.type != DictionarySearchQueryStop &&
+              furi_message_queue_get(search->queue, &next, 0) == FuriStatusOk) {
+            query = next;
+        }
+        if(query.type == DictionarySearchQueryStop) break;
+
+        furi_mutex_acquire(search->mutex, FuriWaitForever);
+        if(query.id == search->latest_id) {
+            search->query = query;
+            dictionary_search_run(search);
+        }
+        furi_mutex_release(search->mutex);
+    }
+    return 0;
+}
+
+// Start the worker
+DictionarySearch* dictionary_search_alloc(FuriMutex* mutex, DictionarySearchCallback callback, void* context) {
+    DictionarySearch* search = malloc(sizeof(DictionarySearch));
+    memset(search, 0, sizeof(DictionarySearch));
+    search->mutex = mutex;
+    search->callback = callback;
+    search->context = context;
+    search->queue = furi_message_queue_alloc(DICTIONARY_SEARCH_QUEUE_SIZE, sizeof(DictionarySearchQuery));
+
+    // Below the event loop, so a key is handled as soon as the worker lets go
+    search->thread = furi_thread_alloc_ex(
+        "DictionarySearch", DICTIONARY_SEARCH_STACK_SIZE, dictionary_search_worker, search);
+    furi_thread_set_priority(search->thread, FuriThreadPriorityLow);
+    furi_thread_start(search->thread);
+    return search;
+}
+
+// Cancel the running query and stop the worker
+void dictionary_search_free(DictionarySearch* search) {
+    furi_mutex_acquire(search->mutex, FuriWaitForever);
+    dictionary_search_cancel(search);
+    furi_mutex_release(search->mutex);
+
+    DictionarySearchQuery stop = {.type = DictionarySearchQueryStop};
+    furi_message_queue_put(search->queue, &stop, FuriWaitForever);
+    furi_thread_join(search->thread);
+    furi_thread_free(search->thread);
+    furi_message_queue_free(search->queue);
+    free(search);
+}
+
+// Queue a query, cancelling the one in flight
+uint32_t dictionary_search_submit(DictionarySearch* search, DictionarySearchQuery* query) {
+    query->id = ++search->latest_id;
+    if(query->max_results > DICTIONARY_SEARCH_RESULTS_MAX) {
+        query->max_results = DICTIONARY_SEARCH_RESULTS_MAX;
+    }
+
+    // Never wait with the mutex held: the worker may need it to get to the
+    // queue, and whatever fills the queue is cancelled by this query
+    if(furi_message_queue_put(search->queue, query, 0) != FuriStatusOk) {
+        furi_message_queue_reset(search->queue);
+        furi_message_queue_put(search->queue, query, 0);
+    }
+    return query->id;
+}
+
+// Cancel the query in flight
+void dictionary_search_cancel(DictionarySearch* search) {
+    search->latest_id++;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "furi.h"
+#include "dictionary_data.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Background worker for the queries that can take long on a large
+// dictionary: full-text search, "did you mean" and the most frequent
+// completions.
+//
+// Queries go to a thread of their own through a message queue, so the event
+// loop keeps handling input while one runs. The worker and the app share the
+// dictionary data under the app's mutex: the worker holds it while it works
+// and lets go of it every DICTIONARY_DATA_PROGRESS_STEPS steps, so keys get
+// in between; the draw callback does not wait for it at all. Submitting a query cancels the one in flight at
+// its next step. Results stream back through a callback, called on the
+// worker thread with the mutex held, each time the query has found more and
+// once more when it is done.
+
+// Most results of a query
+#define DICTIONARY_SEARCH_RESULTS_MAX 32
+
+// Longest search term in bytes, without the terminator
+#define DICTIONARY_SEARCH_TERM_MAX 31
+
+// Kinds of queries
+typedef enum {
+    DictionarySearchQueryCompletions, // Most frequent words of a prefix range
+    DictionarySearchQuerySuggestions, // Words within two edits of the term
+    DictionarySearchQueryDefinitions, // Words whose definition contains every word of the term
+    DictionarySearchQueryStop,        // Ends the worker, sent by dictionary_search_free()
+} DictionarySearchQueryType;
+
+typedef struct {
+    DictionarySearchQueryType type;
+    uint32_t id; // Set by dictionary_search_submit()
+    char term[DICTIONARY_SEARCH_TERM_MAX + 1];
+    DictionaryPrefix prefix; // Range of the completions
+    uint32_t max_results;
+} DictionarySearchQuery;
+
+// Results of a query so far
+typedef struct {
+    uint32_t id; // Query they belong to
+    DictionarySearchQueryType type;
+    bool done;      // Final results, the query ran to the end
+    uint32_t count; // Results in indices
+    uint32_t total; // Results found, more than count if not all were kept
+    uint32_t indices[DICTIONARY_SEARCH_RESULTS_MAX];
+    uint8_t scores[DICTIONARY_SEARCH_RESULTS_MAX]; // Rank of a completion or distance of a suggestion
+} DictionarySearchResults;
+
+// Called on the worker thread with the mutex held
+typedef void (*DictionarySearchCallback)(const DictionarySearchResults* results, void* context);
+
+typedef struct DictionarySearch DictionarySearch;
+
+// Start the worker. mutex guards the dictionary data and whatever the
+// callback touches.
+DictionarySearch* dictionary_search_alloc(FuriMutex* mutex, DictionarySearchCallback callback, void* context);
+
+// Cancel the running query and stop the worker. Must be called without
+// holding the mutex.
+void dictionary_search_free(DictionarySearch* search);
+
+// Queue a query, cancelling the one in flight. Must be called with the mutex
+// held. Returns the id of the query, which its results carry.
+uint32_t dictionary_search_submit(DictionarySearch* search, DictionarySearchQuery* query);
+
+// Cancel the query in flight, it reports no more results. Must be called
+// with the mutex held.
+void dictionary_search_cancel(DictionarySearch* search);
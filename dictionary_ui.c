@@ -2,6 +2,8 @@
 #include "dictionary_app.h"
 #include "dictionary_data.h"
 #include "dictionary_i.h"
+#include "dictionary_layout.h"
+#include "dictionary_profile.h"
 
 #include "furi.h"
 #include "gui/elements.h"
@@ -12,16 +14,113 @@
 #include <stdio.h>
 #include <string.h>
 
-// UI drawing callback
-void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
-    DictionaryApp* app = context;
-    
+// Longest text cut to fit by dictionary_ui_draw_fitted(), in bytes
+#define DICTIONARY_UI_FITTED_MAX 63
+
+// Draw a text cut to end left of right, with "..." if it is too wide. font
+// must match the font set on the canvas.
+static void dictionary_ui_draw_fitted(
+    Canvas* canvas,
+    DictionaryGlyphsFont font,
+    int32_t x,
+    int32_t y,
+    int32_t right,
+    const char* text) {
+    char fitted[DICTIONARY_UI_FITTED_MAX + 4];
+    dictionary_layout_cut(font, text, right > x ? right - x : 0, fitted, sizeof(fitted));
+    canvas_draw_str(canvas, x, y, fitted);
+}
+
+// Rows of the main list are the words themselves
+static uint32_t dictionary_ui_get_word(uint32_t position, void* context) {
+    UNUSED(context);
+    return position;
+}
+
+// Rows of the search results list
+static uint32_t dictionary_ui_get_search_result(uint32_t position, void* context) {
+    return dictionary_app_get_search_result(context, position);
+}
+
+// Rows of the favorites or recent lookups list
+static uint32_t dictionary_ui_get_list_item(uint32_t position, void* context) {
+    return dictionary_app_get_list_item(context, position);
+}
+
+#if DICTIONARY_PROFILE
+// Draw the profile view, a page of the summary lines
+static void dictionary_ui_draw_profile(Canvas* canvas, DictionaryApp* app) {
+    canvas_draw_str(canvas, 2, 10, "Profile");
+    canvas_set_font(canvas, FontSecondary);
+    if(app->profile_status != NULL) {
+        canvas_draw_str(canvas, 70, 10, app->profile_status);
+    }
+
+    char line[DICTIONARY_UI_FITTED_MAX + 1];
+    uint32_t count = dictionary_profile_get_line_count();
+    for(uint32_t i = 0; i < DICTIONARY_APP_TEXT_LINES && app->profile_position + i < count; i++) {
+        dictionary_profile_format_line(app->profile_position + i, line, sizeof(line));
+        dictionary_ui_draw_fitted(canvas, DictionaryGlyphsFontSecondary, 2, 22 + i * 10, 118, line);
+    }
+    if(app->profile_position > 0) {
+        canvas_draw_str(canvas, 118, 12, "^");
+    }
+    if(app->profile_position + DICTIONARY_APP_TEXT_LINES < count) {
+        canvas_draw_str(canvas, 118, 62, "v");
+    }
+    canvas_draw_str(canvas, 2, 62, "OK: save | ←: reset");
+}
+#endif
+
+// Draw the current view, with the app's mutex held
+static void dictionary_ui_draw(Canvas* canvas, DictionaryApp* app) {
+    DICTIONARY_PROFILE_SCOPE(DictionaryProfileDraw);
     canvas_clear(canvas);
     canvas_set_font(canvas, FontPrimary);
     
+#if DICTIONARY_PROFILE
+    if(app->showing_profile) {
+        dictionary_ui_draw_profile(canvas, app);
+        return;
+    }
+#endif
+
     if(app->is_searching) {
         // Draw search mode UI
-        canvas_draw_str(canvas, 2, 10, "Search:");
+        const char* title = "Search EN:";
+        if(app->search_mode == DictionarySearchRussian) {
+            title = "Search RU:";
+        } else if(app->search_mode == DictionarySearchText) {
+            title = "Search text:";
+        }
+        canvas_draw_str(canvas, 2, 10, title);
+
+        // Words or translations matching so far, narrowed as each letter is entered
+        if(app->search_term_length > 0 && app->search_mode != DictionarySearchText) {
+            const DictionaryPrefix* prefix = &app->search_prefix[app->search_term_length];
+            char matches_label[24];
+            snprintf(
+                matches_label,
+                sizeof(matches_label),
+                app->search_mode == DictionarySearchRussian ? "%lu found" : "%lu words",
+                (unsigned long)(prefix->last - prefix->first));
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 75, 10, matches_label);
+            canvas_set_font(canvas, FontPrimary);
+        } else if(app->search_term_length > 0) {
+            // Matches counted by the search worker so far
+            char matches_label[24];
+            if(app->search_done) {
+                snprintf(matches_label, sizeof(matches_label), "%lu found", (unsigned long)app->search_results_total);
+            } else if(app->search_results_total > 0) {
+                snprintf(matches_label, sizeof(matches_label), "%lu+ found", (unsigned long)app->search_results_total);
+            } else {
+                snprintf(matches_label, sizeof(matches_label), "searching");
+            }
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 75, 10, matches_label);
+            canvas_set_font(canvas, FontPrimary);
+        }
         
         // Draw search box
         canvas_draw_frame(canvas, 0, 15, 128, 15);
@@ -37,7 +136,11 @@ void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
         // Draw instructions
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 2, 42, "Up/Down: change letter");
-        canvas_draw_str(canvas, 2, 52, "Left/Right: move cursor");
+        if(app->search_term_length > 0) {
+            canvas_draw_str(canvas, 2, 52, "Left: delete | Right: add");
+        } else {
+            canvas_draw_str(canvas, 2, 52, "Left: mode | Right: add");
+        }
         
         // Additional helper messages
         if(app->search_term_length > 0) {
@@ -51,80 +154,22 @@ void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
         
         // Get the current word
         const char* word = dictionary_data_get_word(app->current_word_index);
-        canvas_draw_str(canvas, 2, 10, word);
+        dictionary_ui_draw_fitted(canvas, DictionaryGlyphsFontPrimary, 2, 10, 108, word);
         
-        // Draw definition or translation
+        // Draw definition or translation, wrapped once per entry and mode
         canvas_set_font(canvas, FontSecondary);
-        const char* text;
-        
-        if(app->show_translation) {
-            // Show Russian translation
-            text = dictionary_data_get_translation_by_index(app->current_word_index);
-            
-            // Display mode indicator
-            canvas_draw_str(canvas, 110, 10, "[РУС]");
-        } else {
-            // Show English definition
-            text = dictionary_data_get_definition(word);
-            
-            // Display mode indicator 
-            canvas_draw_str(canvas, 110, 10, "[ENG]");
-        }
-        
-        // Handle text wrapping and scrolling
-        uint8_t y_pos = 22;
-        uint8_t line_height = 10;
-        
-        uint8_t max_chars_per_line = 21; // Characters that fit on screen width
-        uint8_t current_line = 0;
-        
-        // text variable is already defined above when selecting between definition and translation
-        size_t text_length = strlen(text);
-        size_t start_pos = 0;
-        
-        while(start_pos < text_length) {
-            // Calculate how many characters fit on this line
-            size_t chars_this_line = 0;
-            size_t last_space = 0;
-            
-            for(size_t i = 0; i < max_chars_per_line && (start_pos + i) < text_length; i++) {
-                chars_this_line++;
-                if(text[start_pos + i] == ' ') {
-                    last_space = i;
-                }
-            }
-            
-            // If we found a space and didn't reach the end of text, break at the last space
-            if(last_space > 0 && (start_pos + chars_this_line) < text_length) {
-                chars_this_line = last_space + 1; // Include the space
-            }
-            
-            // Check if this line should be displayed (based on scroll position)
-            if(current_line >= app->scroll_position && current_line < app->scroll_position + 4) {
-                // Draw the line
-                char line_buffer[22]; // Max chars per line + null terminator
-                memcpy(line_buffer, text + start_pos, chars_this_line);
-                line_buffer[chars_this_line] = '\0';
-                
-                canvas_draw_str(
-                    canvas, 
-                    2, 
-                    y_pos + (current_line - app->scroll_position) * line_height, 
-                    line_buffer);
-            }
-            
-            // Move to next line
-            start_pos += chars_this_line;
-            current_line++;
+        canvas_draw_str(canvas, 110, 10, app->show_translation ? "[РУС]" : "[ENG]");
+        const DictionaryLayoutText* wrapped =
+            dictionary_layout_get(app->layout, app->current_word_index, app->show_translation);
+        for(uint32_t i = 0; i < DICTIONARY_APP_TEXT_LINES && app->scroll_position + i < wrapped->line_count; i++) {
+            canvas_draw_str(canvas, 2, 22 + i * 10, dictionary_layout_get_line(wrapped, app->scroll_position + i));
         }
         
         // Draw scroll indicators if needed
         if(app->scroll_position > 0) {
             canvas_draw_str(canvas, 118, 12, "^");
         }
-        
-        int total_lines = dictionary_ui_count_lines(text);
-        if((int)(app->scroll_position + 4) < total_lines) {
+        if(app->scroll_position + DICTIONARY_APP_TEXT_LINES < wrapped->line_count) {
             canvas_draw_str(canvas, 118, 62, "v");
         }
         
@@ -133,9 +178,14 @@ void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
         canvas_draw_str(canvas, 2, 62, "←: toggle | ↑↓: scroll");
     } else if(app->showing_search_results) {
         // Draw search results UI
-        canvas_draw_str(canvas, 2, 10, "Search Results");
+        canvas_draw_str(canvas, 2, 10, app->search_results_source == DictionaryResultsSuggestions ? "Did you mean" : "Search Results");
         
-        if(app->search_results_count == 0) {
+        if(app->search_results_count == 0 && !app->search_done) {
+            // The search worker has found nothing yet
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 2, 35, "Searching...");
+            canvas_draw_str(canvas, 2, 45, "Press BACK to cancel");
+        } else if(app->search_results_count == 0) {
             // No results message
             canvas_set_font(canvas, FontSecondary);
             canvas_draw_str(canvas, 2, 35, "No matching words found");
@@ -144,93 +194,56 @@ void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
             // Show search term
             canvas_set_font(canvas, FontSecondary);
             char search_label[60]; // Increased buffer size
-            snprintf(search_label, sizeof(search_label), "Term: %s (%u results)", 
-                    app->search_term, app->search_results_count);
-            canvas_draw_str(canvas, 5, 20, search_label);
-            
-            // Draw search results list
-            canvas_set_font(canvas, FontPrimary);
-            uint32_t first_visible = 0;
-            
-            // Adjust view to keep selection visible
-            if(app->current_search_index > 1) {
-                first_visible = app->current_search_index - 1;
+            if(app->search_results_source == DictionaryResultsSuggestions) {
+                snprintf(search_label, sizeof(search_label), "No words start with %s", app->search_term);
+            } else if(app->search_results_source == DictionaryResultsDefinitions) {
+                snprintf(search_label, sizeof(search_label), app->search_done ? "Text: %s (%lu results)" : "Text: %s (%lu+ results)",
+                        app->search_term, (unsigned long)app->search_results_total);
+            } else {
+                snprintf(search_label, sizeof(search_label), "Term: %s (%u results)", 
+                        app->search_term, app->search_results_count);
             }
+            dictionary_ui_draw_fitted(canvas, DictionaryGlyphsFontSecondary, 5, 20, 126, search_label);
             
-            // Draw visible search results
-            for(uint32_t i = 0; i < 3 && (first_visible + i) < app->search_results_count; i++) {
-                uint32_t word_index = app->search_results[first_visible + i];
-                const char* word = dictionary_data_get_word(word_index);
-                
-                // Check if this word is a favorite
-                bool is_favorite = false;
-                for(uint8_t f = 0; f < app->favorites_count; f++) {
-                    if(app->favorites[f] == word_index) {
-                        is_favorite = true;
-                        break;
-                    }
-                }
-                
-                // Highlight selected search result
-                if(first_visible + i == app->current_search_index) {
-                    canvas_draw_frame(canvas, 0, 25 + i * 10, 128, 12);
-                    if(is_favorite) {
-                        // Add star for favorites
-                        canvas_draw_str(canvas, 5, 35 + i * 10, "★ ");
-                        canvas_draw_str(canvas, 17, 35 + i * 10, word);
-                    } else {
-                        canvas_draw_str(canvas, 5, 35 + i * 10, word);
-                    }
-                } else {
-                    if(is_favorite) {
-                        // Add star for favorites
-                        canvas_draw_str(canvas, 5, 35 + i * 10, "★ ");
-                        canvas_draw_str(canvas, 17, 35 + i * 10, word);
-                    } else {
-                        canvas_draw_str(canvas, 5, 35 + i * 10, word);
-                    }
-                }
-            }
+            // Draw search results list
+            dictionary_list_draw(
+                app->result_list,
+                canvas,
+                app->current_search_index,
+                app->search_results_count,
+                dictionary_ui_get_search_result,
+                app,
+                app->favorites);
             
             // Draw navigation instructions
             canvas_set_font(canvas, FontSecondary);
             canvas_draw_str(canvas, 2, 62, "OK: view | →: ★ | ↓↑: move");
         }
 } else if(app->showing_favorites) {
-        // Draw favorites UI
-        canvas_draw_str(canvas, 2, 10, "Favorites");
+        // Draw favorites UI, or the recent lookups
+        canvas_draw_str(canvas, 2, 10, app->showing_history ? "Recent" : "Favorites");
         
-        if(app->favorites_count == 0) {
+        uint32_t favorites_count = dictionary_app_get_list_count(app);
+        if(favorites_count == 0) {
             // No favorites message
             canvas_set_font(canvas, FontSecondary);
-            canvas_draw_str(canvas, 2, 35, "No favorites added yet");
+            canvas_draw_str(canvas, 2, 35, app->showing_history ? "No words looked up yet" : "No favorites added yet");
             canvas_draw_str(canvas, 2, 45, "Press BACK to return");
         } else {
             // Draw favorites list
-            uint8_t first_visible = 0;
-            
-            // Adjust view to keep selection visible
-            if(app->current_favorite_index > 2) {
-                first_visible = app->current_favorite_index - 2;
-            }
-            
-            // Draw visible favorites
-            for(uint8_t i = 0; i < 5 && (first_visible + i) < app->favorites_count; i++) {
-                uint32_t word_index = app->favorites[first_visible + i];
-                const char* word = dictionary_data_get_word(word_index);
-                
-                // Highlight selected favorite
-                if(first_visible + i == app->current_favorite_index) {
-                    canvas_draw_frame(canvas, 0, 15 + i * 10, 128, 12);
-                    canvas_draw_str(canvas, 5, 25 + i * 10, word);
-                } else {
-                    canvas_draw_str(canvas, 5, 25 + i * 10, word);
-                }
-            }
+            dictionary_list_draw(
+                app->favorite_list,
+                canvas,
+                app->current_favorite_index,
+                favorites_count,
+                dictionary_ui_get_list_item,
+                app,
+                NULL);
             
             // Draw navigation instructions
             canvas_set_font(canvas, FontSecondary);
-            canvas_draw_str(canvas, 2, 62, "OK: view | →: remove | ↓↑: move");
+            canvas_draw_str(
+                canvas, 2, 62, app->showing_history ? "OK: view | ←: favs | ↓↑: move" : "OK: view | →: remove | ←: recent");
         }
     } else {
         // Draw main dictionary UI
@@ -238,96 +251,81 @@ void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
         
         // Draw the current word list
         uint32_t word_count = dictionary_data_get_word_count();
-        uint32_t first_visible = 0;
-        
-        // Adjust view to keep selection visible
-        if(app->current_word_index > 2) {
-            first_visible = app->current_word_index - 2;
-        }
-        
-        // Draw visible words
-        for(uint32_t i = 0; i < 5 && first_visible + i < word_count; i++) {
-            const char* word = dictionary_data_get_word(first_visible + i);
-            uint32_t word_index = first_visible + i;
-            
-            // Check if this word is a favorite
-            bool is_favorite = false;
-            for(uint8_t f = 0; f < app->favorites_count; f++) {
-                if(app->favorites[f] == word_index) {
-                    is_favorite = true;
-                    break;
-                }
-            }
-            
-            // Highlight selected word
-            if(first_visible + i == app->current_word_index) {
-                canvas_draw_frame(canvas, 0, 15 + i * 10, 128, 12);
-                if(is_favorite) {
-                    // Add star for favorites
-                    canvas_draw_str(canvas, 5, 25 + i * 10, "★ ");
-                    canvas_draw_str(canvas, 17, 25 + i * 10, word);
-                } else {
-                    canvas_draw_str(canvas, 5, 25 + i * 10, word);
-                }
-            } else {
-                if(is_favorite) {
-                    // Add star for favorites
-                    canvas_draw_str(canvas, 5, 25 + i * 10, "★ ");
-                    canvas_draw_str(canvas, 17, 25 + i * 10, word);
-                } else {
-                    canvas_draw_str(canvas, 5, 25 + i * 10, word);
-                }
-            }
+        if(word_count == 0) {
+            // No dictionary image could be loaded from storage
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 2, 30, "No dictionary found");
+            canvas_draw_str(canvas, 2, 40, "Copy dictionary.dict to");
+            canvas_draw_str(canvas, 2, 50, "apps_data/dictionary");
+            return;
         }
-        
+        // Words with their position on a scrollbar
+        dictionary_list_draw(
+            app->word_list, canvas, app->current_word_index, word_count, dictionary_ui_get_word, app, app->favorites);
+
         // Draw navigation instructions
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 2, 62, "OK: search | ←: favs | →: ★/☆");
     }
 }
 
+// Draw the last frame sent to the display again
+static void dictionary_ui_draw_last_frame(Canvas* canvas, DictionaryApp* app) {
+    canvas_clear(canvas);
+    if(!app->frame_valid) return;
+
+    for(uint32_t i = 0; i < DICTIONARY_APP_FRAME_SIZE; i++) {
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            if(app->frame[i] & (1 << bit)) {
+                canvas_draw_dot(canvas, i % 128, (i / 128) * 8 + bit);
+            }
+        }
+    }
+}
+
+// UI drawing callback, runs on the GUI thread
+void dictionary_ui_draw_callback(Canvas* canvas, void* context) {
+    DictionaryApp* app = context;
+
+    // Never wait for the search worker, it may hold the mutex for many
+    // storage reads. Show the frame on screen again instead, and have the
+    // event loop ask for a fresh one once it has the mutex.
+    if(furi_mutex_acquire(app->mutex, 0) != FuriStatusOk) {
+        dictionary_ui_draw_last_frame(canvas, app);
+        DictionaryEvent event = {.type = DictionaryEventRedraw};
+        furi_message_queue_put(app->event_queue, &event, 0);
+        return;
+    }
+    dictionary_ui_draw(canvas, app);
+    furi_mutex_release(app->mutex);
+}
+
+// Frame buffer callback, runs on the GUI thread after each frame
+void dictionary_ui_framebuffer_callback(uint8_t* data, size_t size, CanvasOrientation orientation, void* context) {
+    DictionaryApp* app = context;
+    app->frame_valid = size == DICTIONARY_APP_FRAME_SIZE && orientation == CanvasOrientationHorizontal;
+    if(app->frame_valid) {
+        memcpy(app->frame, data, size);
+    }
+}
+
 // UI input handling callback for the ViewPort
 void dictionary_ui_input_callback(InputEvent* input_event, void* ctx) {
     // Forward events to the app's event queue
     furi_assert(ctx != NULL);
     DictionaryApp* app = ctx;
-    
-    // Put event into the queue
-    furi_message_queue_put(app->event_queue, input_event, FuriWaitForever);
-}
 
-// Count the number of lines a text would take when rendered
-int dictionary_ui_count_lines(const char* text) {
-    if(text == NULL) return 0;
-    
-    int lines = 1;
-    size_t max_chars_per_line = 21;
-    size_t text_length = strlen(text);
-    size_t start_pos = 0;
-    
-    while(start_pos < text_length) {
-        // Calculate how many characters fit on this line
-        size_t chars_this_line = 0;
-        size_t last_space = 0;
-        
-        for(size_t i = 0; i < max_chars_per_line && (start_pos + i) < text_length; i++) {
-            chars_this_line++;
-            if(text[start_pos + i] == ' ') {
-                last_space = i;
-            }
-        }
-        
-        // If we found a space and didn't reach the end of text, break at the last space
-        if(last_space > 0 && (start_pos + chars_this_line) < text_length) {
-            chars_this_line = last_space + 1; // Include the space
-        }
-        
-        // Move to next line
-        start_pos += chars_this_line;
-        if(start_pos < text_length) {
-            lines++;
-        }
+    // The app acts on presses and their repeats, and on short and long
+    // presses only of Left and Right in the main list. The rest would fill
+    // the queue, and split runs of presses the event loop merges into one step.
+    if(input_event->type == InputTypeRelease) return;
+    if((input_event->type == InputTypeShort || input_event->type == InputTypeLong) &&
+       input_event->key != InputKeyLeft && input_event->key != InputKeyRight) {
+        return;
     }
-    
-    return lines;
+
+    // Runs on the GUI thread, so never wait: with the queue full the app is
+    // behind on presses already and this one is dropped
+    DictionaryEvent event = {.type = DictionaryEventInput, .input = *input_event};
+    furi_message_queue_put(app->event_queue, &event, 0);
 }
@@ -9,8 +9,9 @@ struct DictionaryApp;
 // UI drawing callback
 void dictionary_ui_draw_callback(Canvas* canvas, void* context);
 
+// Frame buffer callback, keeps the last frame for the draw callback
+void dictionary_ui_framebuffer_callback(uint8_t* data, size_t size, CanvasOrientation orientation, void* context);
+
 // UI input handling callback
 void dictionary_ui_input_callback(InputEvent* input_event, void* ctx);
 
-// Helper functions
-int dictionary_ui_count_lines(const char* text);
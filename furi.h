@@ -7,6 +7,8 @@
 // Basic types
 typedef int FuriStatus;
 typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriThread FuriThread;
 typedef struct NotificationApp NotificationApp;
 
 // Status codes
@@ -23,11 +25,50 @@ typedef struct NotificationApp NotificationApp;
 // Assert function - casts pointer to bool for compatibility
 void furi_assert(int condition);
 
+// Check function - unlike furi_assert it stays enabled in release builds
+void furi_check(int condition);
+
+// Logging
+#define FURI_LOG_E(tag, format, ...) furi_log_print_format(1, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) furi_log_print_format(2, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) furi_log_print_format(3, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) furi_log_print_format(4, tag, format, ##__VA_ARGS__)
+void furi_log_print_format(int level, const char* tag, const char* format, ...);
+
 // Message queue functions
 FuriMessageQueue* furi_message_queue_alloc(uint32_t size, uint32_t item_size);
 void furi_message_queue_free(FuriMessageQueue* queue);
 int furi_message_queue_get(FuriMessageQueue* queue, void* message, uint32_t timeout);
-void furi_message_queue_put(FuriMessageQueue* queue, void* message, uint32_t timeout);
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* message, uint32_t timeout);
+FuriStatus furi_message_queue_reset(FuriMessageQueue* queue);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue);
+
+// Mutex functions
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+// Thread functions
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+typedef enum {
+    FuriThreadPriorityLow = 15,
+    FuriThreadPriorityNormal = 16,
+    FuriThreadPriorityHigh = 17,
+} FuriThreadPriority;
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+void furi_thread_yield(void);
 
 // Record functions
 void* furi_record_open(const char* record_name);
@@ -0,0 +1,16 @@
+// Mock furi_hal.h for simulation
+#pragma once
+
+#include <stdint.h>
+
+// Cortex-M debug watchpoint and trace unit, only the cycle counter
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+// The host reads its clock into the counter on each access
+DWT_Type* furi_hal_host_get_dwt(void);
+#define DWT (furi_hal_host_get_dwt())
+
+// CPU cycles per microsecond, 64 on the device
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
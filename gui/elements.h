@@ -1,6 +1,8 @@
 // Mock elements.h for simulation
 #pragma once
 
+#include <stddef.h>
+
 #include "../furi.h"
 #include "gui.h"
 
@@ -12,6 +14,10 @@ void canvas_clear(Canvas* canvas);
 void canvas_set_font(Canvas* canvas, int font);
 void canvas_draw_str(Canvas* canvas, int x, int y, const char* str);
 void canvas_draw_frame(Canvas* canvas, int x, int y, int width, int height);
+void canvas_draw_dot(Canvas* canvas, int x, int y);
+
+// Vertical scrollbar left of x, from y down height pixels, at pos of total
+void elements_scrollbar_pos(Canvas* canvas, int32_t x, int32_t y, size_t height, size_t pos, size_t total);
 
 // Font definitions
 #define FontPrimary 1
@@ -1,6 +1,8 @@
 // Mock gui.h for simulation
 #pragma once
 
+#include <stddef.h>
+
 #include "../furi.h"
 #include "../input/input.h"
 
@@ -12,6 +14,17 @@ typedef struct Canvas Canvas;
 // Constants
 #define GuiLayerFullscreen 0
 
+typedef enum {
+    CanvasOrientationHorizontal,
+    CanvasOrientationHorizontalFlip,
+    CanvasOrientationVertical,
+    CanvasOrientationVerticalFlip,
+} CanvasOrientation;
+
+// Called with the frame buffer each time a frame goes to the display: eight
+// rows of 128 bytes, each byte a column of 8 pixels with the top one in bit 0
+typedef void (*GuiCanvasCommitCallback)(uint8_t* data, size_t size, CanvasOrientation orientation, void* context);
+
 // Functions
 ViewPort* view_port_alloc();
 void view_port_free(ViewPort* view_port);
@@ -20,3 +33,5 @@ void view_port_input_callback_set(ViewPort* view_port, void (*callback)(InputEve
 void view_port_update(ViewPort* view_port);
 void gui_add_view_port(Gui* gui, ViewPort* view_port, int layer);
 void gui_remove_view_port(Gui* gui, ViewPort* view_port);
+void gui_add_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context);
+void gui_remove_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context);
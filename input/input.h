@@ -12,6 +12,9 @@ typedef struct {
 // Constants for input handling
 #define InputTypePress 1
 #define InputTypeRelease 2
+#define InputTypeShort 3  // Released before the long press delay
+#define InputTypeLong 4   // Held past the long press delay
+#define InputTypeRepeat 5 // Still held, sent periodically after InputTypeLong
 #define InputKeyUp 1
 #define InputKeyDown 2
 #define InputKeyRight 3
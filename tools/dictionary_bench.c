@@ -0,0 +1,669 @@
+// Benchmark of the dictionary_data.h API
+//
+// Compiles sorted synthetic dictionaries of growing size, loads them through
+// the data layer from (host) storage and times every lookup of the API
+// together with the storage reads it causes: word access at random and in
+// order, definitions and translations by word and by index, exact, prefix,
+// letter-by-letter, "did you mean", Russian, full-text and most frequent
+// completion searches, letter jumps, read-ahead while scrolling, and wrapping
+// a definition for the word view. The compressed sizes of the image are
+// reported next to the timings.
+//
+// The words follow the length distribution of English headwords and the
+// letter frequencies of English text; definitions are mostly one line, with
+// a tail of long ones; translations are one to three made-up Russian words.
+//
+// Usage: dictionary_bench [-f text|csv|json] [-s size,size,...]
+// The default sizes are 1000 to 1000000 words. csv and json print one record
+// per size and metric, for comparing runs; text prints a table. Run with
+// `make bench`.
+
+#include "dictionary_data.h"
+#include "dictionary_compiler.h"
+#include "dictionary_format.h"
+#include "dictionary_layout.h"
+#include "host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DIR "build/bench"
+#define BENCH_LOOKUPS 20000
+#define BENCH_FUZZY_LOOKUPS 200
+#define BENCH_SIZES_MAX 16
+
+// Rows drawn at once by the tallest list
+#define BENCH_LIST_ROWS 5
+
+typedef enum {
+    BenchFileSize,
+    BenchDawgSize,
+    BenchTextRatio,
+    BenchFindWordIndex,
+    BenchFindWordIndexReads,
+    BenchWordExists,
+    BenchFindPrefixRange,
+    BenchFindWordsWithPrefix,
+    BenchPrefixAdd,
+    BenchPrefixGetNextLetters,
+    BenchFindSimilarWords,
+    BenchFindTranslationRange,
+    BenchTranslationNarrow,
+    BenchTranslationGetNextLetters,
+    BenchGetTranslationEntry,
+    BenchFindWordsWithDefinition,
+    BenchFindTopWords,
+    BenchGetWord,
+    BenchGetWordInOrder,
+    BenchGetWords,
+    BenchGetNextBucket,
+    BenchGetPreviousBucket,
+    BenchGetDefinition,
+    BenchGetDefinitionByIndex,
+    BenchTextCacheHits,
+    BenchGetTranslation,
+    BenchGetTranslationByIndex,
+    BenchBlockDecode,
+    BenchPrefetchHits,
+    BenchLayoutGet,
+    BenchMetricCount,
+} BenchMetric;
+
+typedef struct {
+    const char* name;
+    const char* unit;
+} BenchMetricInfo;
+
+static const BenchMetricInfo bench_metrics[BenchMetricCount] = {
+    [BenchFileSize] = {"file_size", "bytes"},
+    [BenchDawgSize] = {"dawg_size", "bytes/word"},
+    [BenchTextRatio] = {"text_ratio", "x"},
+    [BenchFindWordIndex] = {"find_word_index", "ns"},
+    [BenchFindWordIndexReads] = {"find_word_index_reads", "reads"},
+    [BenchWordExists] = {"word_exists", "ns"},
+    [BenchFindPrefixRange] = {"find_prefix_range", "ns"},
+    [BenchFindWordsWithPrefix] = {"find_words_with_prefix", "ns"},
+    [BenchPrefixAdd] = {"prefix_add", "ns/letter"},
+    [BenchPrefixGetNextLetters] = {"prefix_get_next_letters", "ns"},
+    [BenchFindSimilarWords] = {"find_similar_words", "us"},
+    [BenchFindTranslationRange] = {"find_translation_range", "us"},
+    [BenchTranslationNarrow] = {"translation_narrow", "ns/letter"},
+    [BenchTranslationGetNextLetters] = {"translation_get_next_letters", "us"},
+    [BenchGetTranslationEntry] = {"get_translation_entry", "ns"},
+    [BenchFindWordsWithDefinition] = {"find_words_with_definition", "us"},
+    [BenchFindTopWords] = {"find_top_words", "us"},
+    [BenchGetWord] = {"get_word", "ns"},
+    [BenchGetWordInOrder] = {"get_word_in_order", "ns"},
+    [BenchGetWords] = {"get_words", "ns/row"},
+    [BenchGetNextBucket] = {"get_next_bucket", "ns"},
+    [BenchGetPreviousBucket] = {"get_previous_bucket", "ns"},
+    [BenchGetDefinition] = {"get_definition", "ns"},
+    [BenchGetDefinitionByIndex] = {"get_definition_by_index_in_order", "ns"},
+    [BenchTextCacheHits] = {"text_cache_hits", "%"},
+    [BenchGetTranslation] = {"get_translation", "ns"},
+    [BenchGetTranslationByIndex] = {"get_translation_by_index", "ns"},
+    [BenchBlockDecode] = {"block_decode", "us"},
+    [BenchPrefetchHits] = {"prefetch_hits", "%"},
+    [BenchLayoutGet] = {"layout_get", "us"},
+};
+
+typedef enum {
+    BenchFormatText,
+    BenchFormatCsv,
+    BenchFormatJson,
+} BenchFormat;
+
+static uint32_t bench_sizes[BENCH_SIZES_MAX] = {1000, 10000, 100000, 1000000};
+static uint32_t bench_size_count = 4;
+static double bench_results[BENCH_SIZES_MAX][BenchMetricCount];
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Simple xorshift so runs are reproducible
+static uint32_t bench_rand_state = 2463534242u;
+
+static uint32_t bench_rand(void) {
+    bench_rand_state ^= bench_rand_state << 13;
+    bench_rand_state ^= bench_rand_state >> 17;
+    bench_rand_state ^= bench_rand_state << 5;
+    return bench_rand_state;
+}
+
+// Draw from a table of relative weights
+static uint32_t bench_pick_weighted(const uint8_t* weights, uint32_t count) {
+    uint32_t total = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        total += weights[i];
+    }
+    uint32_t pick = bench_rand() % total;
+    uint32_t i = 0;
+    while(pick >= weights[i]) {
+        pick -= weights[i++];
+    }
+    return i;
+}
+
+// Share of English headwords by length in letters, from 2 letters on
+static const uint8_t bench_word_lengths[] = {1, 4, 8, 12, 14, 14, 13, 11, 8, 6, 4, 2, 2, 1};
+
+// Letter frequencies of English text, in tenths of a percent
+static const uint8_t bench_letters[] = {82, 15, 28, 43, 127, 22, 20, 61, 70, 2,  8,  40, 24,
+                                        67, 75, 19, 1,  60, 63,  91, 28, 10, 24, 2, 20, 1};
+
+static int bench_compare_words(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Generate count distinct lowercase words, sorted
+static char** bench_make_words(uint32_t count) {
+    char** words = malloc(count * sizeof(char*));
+    size_t width = 1;
+    for(uint64_t span = 26; span < count; span *= 26) {
+        width++;
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        // A fixed-width ordinal keeps words distinct, letters drawn by
+        // frequency make up the rest of the length
+        char buffer[24];
+        uint32_t n = i;
+        size_t len = 0;
+        for(size_t w = 0; w < width; w++) {
+            buffer[len++] = 'a' + n % 26;
+            n /= 26;
+        }
+        size_t length = 2 + bench_pick_weighted(bench_word_lengths, sizeof(bench_word_lengths));
+        while(len < length) {
+            buffer[len++] = 'a' + bench_pick_weighted(bench_letters, sizeof(bench_letters));
+        }
+        buffer[len] = '\0';
+        words[i] = strdup(buffer);
+    }
+    qsort(words, count, sizeof(char*), bench_compare_words);
+    return words;
+}
+
+// Common definition words, drawn with a Zipf-like bias towards the front
+static const char* const bench_vocabulary[] = {
+    "a",        "the",      "of",       "or",       "to",      "and",       "in",        "with",
+    "used",     "for",      "that",     "is",       "by",      "as",        "large",     "small",
+    "having",   "being",    "person",   "something", "which",  "who",       "from",      "on",
+    "kind",     "form",     "part",     "state",    "quality", "act",       "process",   "made",
+    "animal",   "plant",    "water",    "body",     "place",   "device",    "instrument", "music",
+    "typically", "especially", "long",  "short",    "round",   "flat",      "covered",   "shaped",
+    "native",   "common",   "wild",     "domestic", "building", "structure", "material",  "metal",
+    "wooden",   "bright",   "colour",   "sound",    "movement", "group",    "number",    "time",
+};
+
+// Syllables of the made-up Russian translations
+static const char* const bench_syllables[] = {
+    "ка", "ро", "ми", "на", "ст", "ол", "ре", "ть", "до", "ва", "ли", "ко",
+    "пе", "за", "бу", "ше", "ёж", "ры", "ся", "чи", "го", "лу", "фа", "эх",
+};
+
+#define BENCH_VOCABULARY_SIZE (sizeof(bench_vocabulary) / sizeof(bench_vocabulary[0]))
+#define BENCH_SYLLABLES_SIZE (sizeof(bench_syllables) / sizeof(bench_syllables[0]))
+
+static const char* bench_pick_word(void) {
+    // Minimum of two uniform draws favours the most common words
+    uint32_t a = bench_rand() % BENCH_VOCABULARY_SIZE;
+    uint32_t b = bench_rand() % BENCH_VOCABULARY_SIZE;
+    return bench_vocabulary[a < b ? a : b];
+}
+
+// Write a definition: mostly ten to thirty words, one in ten much longer
+static void bench_write_definition(FILE* tsv) {
+    char text[DICTIONARY_TEXT_MAX + 1];
+    uint32_t words = 4 + bench_rand() % 13 + bench_rand() % 13;
+    if(bench_rand() % 10 == 0) {
+        words += bench_rand() % 120;
+    }
+    size_t length = (size_t)snprintf(text, sizeof(text), "A");
+    for(uint32_t w = 0; w < words; w++) {
+        const char* word = bench_pick_word();
+        if(length + strlen(word) + 2 >= sizeof(text)) break;
+        length += snprintf(text + length, sizeof(text) - length, " %s", word);
+    }
+    fprintf(tsv, "%s.", text);
+}
+
+// Write a translation of one to three alternatives into tsv and the first
+// one into first
+static void bench_write_translation(FILE* tsv, char* first, size_t size) {
+    uint32_t alternatives = 1 + bench_pick_weighted((const uint8_t[]){6, 3, 1}, 3);
+    for(uint32_t a = 0; a < alternatives; a++) {
+        char alternative[64];
+        size_t length = 0;
+        uint32_t syllables = 2 + bench_rand() % 3;
+        for(uint32_t s = 0; s < syllables; s++) {
+            length += snprintf(
+                alternative + length,
+                sizeof(alternative) - length,
+                "%s",
+                bench_syllables[bench_rand() % BENCH_SYLLABLES_SIZE]);
+        }
+        fprintf(tsv, "%s%s", a > 0 ? ", " : "", alternative);
+        if(a == 0) {
+            snprintf(first, size, "%s", alternative);
+        }
+    }
+}
+
+static bool bench_write_dictionary(
+    char** words,
+    char** translations,
+    uint32_t count,
+    DictionaryCompilerStats* stats) {
+    FILE* tsv = fopen(BENCH_DIR "/input.tsv", "w");
+    if(tsv == NULL) return false;
+    for(uint32_t i = 0; i < count; i++) {
+        char translation[64];
+        fprintf(tsv, "%s\t", words[i]);
+        bench_write_definition(tsv);
+        fputc('\t', tsv);
+        bench_write_translation(tsv, translation, sizeof(translation));
+        fputc('\n', tsv);
+        translations[i] = strdup(translation);
+    }
+    fclose(tsv);
+
+    return dictionary_compiler_compile(BENCH_DIR "/input.tsv", BENCH_DIR "/dictionary.dict", stats);
+}
+
+// Take the first bytes of a translation, in whole two-byte letters
+static void bench_translation_prefix(const char* translation, uint32_t letters, char* prefix, size_t size) {
+    snprintf(prefix, size, "%.*s", 2 * (int)letters, translation);
+}
+
+static void bench_run(uint32_t count, double* results) {
+    fprintf(stderr, "%u words...\n", count);
+    char** words = bench_make_words(count);
+    char** translations = malloc(count * sizeof(char*));
+    DictionaryCompilerStats compiler_stats;
+    if(!bench_write_dictionary(words, translations, count, &compiler_stats)) {
+        fprintf(stderr, "failed to build the %u word dictionary\n", count);
+        exit(1);
+    }
+    results[BenchFileSize] = compiler_stats.file_size;
+    results[BenchDawgSize] = (double)compiler_stats.dawg_size / count;
+    results[BenchTextRatio] = (double)compiler_stats.text_size / compiler_stats.packed_text_size;
+
+    dictionary_data_init();
+    if(dictionary_data_get_word_count() != count) {
+        fprintf(stderr, "loaded %u words, expected %u\n", dictionary_data_get_word_count(), count);
+        exit(1);
+    }
+
+    StorageHostStats stats;
+    DictionaryDataStats data_stats;
+    volatile uint32_t sink = 0;
+
+    // Random hits plus a miss for every eighth probe
+    storage_host_reset_stats();
+    double start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        const char* word = (i % 8 == 7) ? "zzzzzzzzzz" : words[bench_rand() % count];
+        sink += (uint32_t)dictionary_data_find_word_index(word);
+    }
+    results[BenchFindWordIndex] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+    storage_host_get_stats(&stats);
+    results[BenchFindWordIndexReads] = (double)stats.read_calls / BENCH_LOOKUPS;
+
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        const char* word = (i % 8 == 7) ? "zzzzzzzzzz" : words[bench_rand() % count];
+        sink += dictionary_data_word_exists(word);
+    }
+    results[BenchWordExists] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // Prefix ranges for the first one to four letters of random words
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        char prefix[5];
+        strncpy(prefix, words[bench_rand() % count], 1 + i % 4);
+        prefix[1 + i % 4] = '\0';
+        uint32_t first, last;
+        sink += dictionary_data_find_prefix_range(prefix, &first, &last);
+    }
+    results[BenchFindPrefixRange] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // The allocating variant, for two to four letters
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        char prefix[5];
+        strncpy(prefix, words[bench_rand() % count], 2 + i % 3);
+        prefix[2 + i % 3] = '\0';
+        uint32_t* indices = NULL;
+        sink += dictionary_data_find_words_with_prefix(prefix, &indices);
+        free(indices);
+    }
+    results[BenchFindWordsWithPrefix] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // The same prefixes typed letter by letter through the DAWG, per letter,
+    // then the letters the picker offers next
+    uint32_t letters = 0;
+    double next_ns = 0;
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        const char* word = words[bench_rand() % count];
+        DictionaryPrefix prefix;
+        dictionary_data_prefix_start(&prefix);
+        for(uint32_t l = 0; l < 1 + i % 4 && word[l] != '\0'; l++) {
+            sink += dictionary_data_prefix_add(&prefix, word[l]);
+            letters++;
+        }
+        double next_start = bench_now_ns();
+        sink += dictionary_data_prefix_get_next_letters(&prefix);
+        next_ns += bench_now_ns() - next_start;
+    }
+    results[BenchPrefixAdd] = (bench_now_ns() - start - next_ns) / letters;
+    results[BenchPrefixGetNextLetters] = next_ns / BENCH_LOOKUPS;
+
+    // "Did you mean" for words with one letter replaced
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS; i++) {
+        char typo[DICTIONARY_WORD_MAX + 1];
+        strcpy(typo, words[bench_rand() % count]);
+        typo[bench_rand() % strlen(typo)] = 'a' + bench_rand() % 26;
+        DictionaryMatch matches[8];
+        sink += dictionary_data_find_similar_words(typo, 2, matches, 8, NULL, NULL);
+    }
+    results[BenchFindSimilarWords] = (bench_now_ns() - start) / BENCH_FUZZY_LOOKUPS / 1000.0;
+
+    // Russian to English: translation prefixes through the reverse index
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS; i++) {
+        char prefix[16];
+        bench_translation_prefix(translations[bench_rand() % count], 1 + i % 3, prefix, sizeof(prefix));
+        uint32_t first, last;
+        sink += dictionary_data_find_translation_range(prefix, &first, &last);
+    }
+    results[BenchFindTranslationRange] = (bench_now_ns() - start) / BENCH_FUZZY_LOOKUPS / 1000.0;
+
+    // The same typed letter by letter, then the letters offered next and
+    // the entry of a match
+    letters = 0;
+    uint32_t entries = 0;
+    double narrow_ns = 0;
+    double entry_ns = 0;
+    next_ns = 0;
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS; i++) {
+        const char* translation = translations[bench_rand() % count];
+        char prefix[16];
+        DictionaryPrefix range;
+        start = bench_now_ns();
+        dictionary_data_translation_start(&range);
+        for(uint32_t l = 1; l <= 1 + i % 3; l++) {
+            bench_translation_prefix(translation, l, prefix, sizeof(prefix));
+            sink += dictionary_data_translation_narrow(&range, prefix);
+            letters++;
+        }
+        double narrowed = bench_now_ns();
+        uint32_t starts[DICTIONARY_DATA_RUSSIAN_LETTERS + 1];
+        sink += dictionary_data_translation_get_next_letters(&range, prefix, starts);
+        double offered = bench_now_ns();
+        if(range.last > range.first) {
+            sink += dictionary_data_get_translation_entry(range.first + (range.last - range.first) / 2);
+            entry_ns += bench_now_ns() - offered;
+            entries++;
+        }
+        narrow_ns += narrowed - start;
+        next_ns += offered - narrowed;
+    }
+    results[BenchTranslationNarrow] = narrow_ns / letters;
+    results[BenchTranslationGetNextLetters] = next_ns / BENCH_FUZZY_LOOKUPS / 1000.0;
+    results[BenchGetTranslationEntry] = entries ? entry_ns / entries : 0.0;
+
+    // Full-text queries of two definition words, counting every match
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS; i++) {
+        char query[40];
+        snprintf(query, sizeof(query), "%s %s", bench_pick_word(), bench_pick_word());
+        uint32_t results_found[32];
+        sink += dictionary_data_find_words_with_definition(query, results_found, 32, NULL, NULL);
+    }
+    results[BenchFindWordsWithDefinition] = (bench_now_ns() - start) / BENCH_FUZZY_LOOKUPS / 1000.0;
+
+    // The five most frequent completions of one- and two-letter prefixes
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS; i++) {
+        const char* word = words[bench_rand() % count];
+        DictionaryPrefix prefix;
+        dictionary_data_prefix_start(&prefix);
+        for(uint32_t l = 0; l < 1 + i % 2 && word[l] != '\0'; l++) {
+            dictionary_data_prefix_add(&prefix, word[l]);
+        }
+        DictionaryRankedWord top[5];
+        sink += dictionary_data_find_top_words(&prefix, top, 5, NULL, NULL);
+    }
+    results[BenchFindTopWords] = (bench_now_ns() - start) / BENCH_FUZZY_LOOKUPS / 1000.0;
+
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        sink += (uint32_t)(uintptr_t)dictionary_data_get_word(bench_rand() % count);
+    }
+    results[BenchGetWord] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // Scrolling the main list walks the words in order
+    uint32_t scroll = count < BENCH_LOOKUPS ? count : BENCH_LOOKUPS;
+    uint32_t scroll_start = bench_rand() % (count - scroll + 1);
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < scroll; i++) {
+        const char* word = dictionary_data_get_word(scroll_start + i);
+        if(strcmp(word, words[scroll_start + i]) != 0) {
+            fprintf(stderr, "word %u is \"%s\", expected \"%s\"\n", scroll_start + i, word, words[scroll_start + i]);
+            exit(1);
+        }
+    }
+    results[BenchGetWordInOrder] = (bench_now_ns() - start) / scroll;
+
+    // A page of list rows somewhere else at each step
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS / BENCH_LIST_ROWS; i++) {
+        uint32_t indices[BENCH_LIST_ROWS];
+        char rows[BENCH_LIST_ROWS][DICTIONARY_WORD_MAX + 1];
+        uint32_t first = bench_rand() % count;
+        for(uint32_t r = 0; r < BENCH_LIST_ROWS; r++) {
+            indices[r] = first + r;
+        }
+        dictionary_data_get_words(indices, BENCH_LIST_ROWS, rows);
+        sink += rows[0][0];
+    }
+    results[BenchGetWords] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // Holding Down or Right: jumps to the next run of two letters or first
+    // letter, from the start again at the end of the list; then back up
+    uint32_t index = 0;
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        index = dictionary_data_get_next_bucket(index, i % 2 == 0);
+        if(index >= count) {
+            index = 0;
+        }
+        sink += index;
+    }
+    results[BenchGetNextBucket] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    index = count - 1;
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        index = dictionary_data_get_previous_bucket(index, i % 2 == 0);
+        if(index == 0) {
+            index = count - 1;
+        }
+        sink += index;
+    }
+    results[BenchGetPreviousBucket] = (bench_now_ns() - start) / BENCH_LOOKUPS;
+
+    // Definitions and translations of random words, looked up by the word
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS * 10; i++) {
+        sink += strlen(dictionary_data_get_definition(words[bench_rand() % count]));
+    }
+    results[BenchGetDefinition] = (bench_now_ns() - start) / (BENCH_FUZZY_LOOKUPS * 10);
+
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS * 10; i++) {
+        sink += strlen(dictionary_data_get_translation(words[bench_rand() % count]));
+    }
+    results[BenchGetTranslation] = (bench_now_ns() - start) / (BENCH_FUZZY_LOOKUPS * 10);
+
+    // Random translations mostly miss the block cache, so this is the decode cost
+    dictionary_data_get_stats(&data_stats);
+    uint32_t decoded_before = data_stats.blocks_decoded;
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        sink += strlen(dictionary_data_get_translation_by_index(bench_rand() % count));
+    }
+    double random_ns = bench_now_ns() - start;
+    results[BenchGetTranslationByIndex] = random_ns / BENCH_LOOKUPS;
+    dictionary_data_get_stats(&data_stats);
+    uint32_t decoded = data_stats.blocks_decoded - decoded_before;
+    results[BenchBlockDecode] = decoded ? random_ns / decoded / 1000.0 : 0.0;
+
+    // Browsing: definition of each word in order, as scrolling the list does
+    uint32_t lookups_before = data_stats.text_lookups;
+    uint32_t hits_before = data_stats.text_cache_hits;
+    uint32_t browse = count < BENCH_LOOKUPS ? count : BENCH_LOOKUPS;
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < browse; i++) {
+        sink += strlen(dictionary_data_get_definition_by_index(i));
+    }
+    results[BenchGetDefinitionByIndex] = (bench_now_ns() - start) / browse;
+    dictionary_data_get_stats(&data_stats);
+    results[BenchTextCacheHits] = 100.0 * (data_stats.text_cache_hits - hits_before) /
+                                  (data_stats.text_lookups - lookups_before);
+
+    // The same walk backwards from a random place, reading ahead after each
+    // step as the app does: blocks found read ahead against blocks read on request
+    uint32_t prefetch_hits_before = data_stats.prefetch_hits;
+    uint32_t prefetch_misses_before = data_stats.prefetch_misses;
+    index = browse - 1 + bench_rand() % (count - browse + 1);
+    for(uint32_t i = 0; i < browse; i++, index--) {
+        sink += strlen(dictionary_data_get_word(index));
+        sink += strlen(dictionary_data_get_definition_by_index(index));
+        dictionary_data_prefetch(index, false);
+    }
+    dictionary_data_get_stats(&data_stats);
+    uint32_t prefetch_hits = data_stats.prefetch_hits - prefetch_hits_before;
+    uint32_t prefetch_misses = data_stats.prefetch_misses - prefetch_misses_before;
+    results[BenchPrefetchHits] =
+        prefetch_hits + prefetch_misses ? 100.0 * prefetch_hits / (prefetch_hits + prefetch_misses) : 100.0;
+
+    // Opening the word view of random words wraps their definition
+    DictionaryLayout* layout = dictionary_layout_alloc();
+    start = bench_now_ns();
+    for(uint32_t i = 0; i < BENCH_FUZZY_LOOKUPS * 10; i++) {
+        sink += dictionary_layout_get(layout, bench_rand() % count, false)->line_count;
+    }
+    results[BenchLayoutGet] = (bench_now_ns() - start) / (BENCH_FUZZY_LOOKUPS * 10) / 1000.0;
+    dictionary_layout_free(layout);
+    (void)sink;
+
+    dictionary_data_free();
+    for(uint32_t i = 0; i < count; i++) {
+        free(words[i]);
+        free(translations[i]);
+    }
+    free(words);
+    free(translations);
+}
+
+// Print a metric per row and a size per column
+static void bench_print_text(void) {
+    printf("%-34s %-10s", "metric", "unit");
+    for(uint32_t s = 0; s < bench_size_count; s++) {
+        printf(" %11u", bench_sizes[s]);
+    }
+    printf("\n");
+    for(uint32_t m = 0; m < BenchMetricCount; m++) {
+        printf("%-34s %-10s", bench_metrics[m].name, bench_metrics[m].unit);
+        for(uint32_t s = 0; s < bench_size_count; s++) {
+            printf(" %11.*f", bench_results[s][m] < 100.0 ? 2 : 0, bench_results[s][m]);
+        }
+        printf("\n");
+    }
+}
+
+static void bench_print_csv(void) {
+    printf("words,metric,unit,value\n");
+    for(uint32_t s = 0; s < bench_size_count; s++) {
+        for(uint32_t m = 0; m < BenchMetricCount; m++) {
+            printf(
+                "%u,%s,%s,%.3f\n", bench_sizes[s], bench_metrics[m].name, bench_metrics[m].unit, bench_results[s][m]);
+        }
+    }
+}
+
+static void bench_print_json(void) {
+    printf("[\n");
+    for(uint32_t s = 0; s < bench_size_count; s++) {
+        for(uint32_t m = 0; m < BenchMetricCount; m++) {
+            bool last = s + 1 == bench_size_count && m + 1 == BenchMetricCount;
+            printf(
+                "  {\"words\": %u, \"metric\": \"%s\", \"unit\": \"%s\", \"value\": %.3f}%s\n",
+                bench_sizes[s],
+                bench_metrics[m].name,
+                bench_metrics[m].unit,
+                bench_results[s][m],
+                last ? "" : ",");
+        }
+    }
+    printf("]\n");
+}
+
+// Parse a comma-separated list of sizes
+static bool bench_parse_sizes(const char* list) {
+    bench_size_count = 0;
+    while(*list != '\0') {
+        char* end;
+        unsigned long size = strtoul(list, &end, 10);
+        if(end == list || size == 0 || bench_size_count == BENCH_SIZES_MAX) return false;
+        bench_sizes[bench_size_count++] = size;
+        list = *end == ',' ? end + 1 : end;
+        if(*end != ',' && *end != '\0') return false;
+    }
+    return bench_size_count > 0;
+}
+
+int main(int argc, char** argv) {
+    BenchFormat format = BenchFormatText;
+    int opt;
+    while((opt = getopt(argc, argv, "f:s:")) != -1) {
+        if(opt == 'f' && strcmp(optarg, "text") == 0) {
+            format = BenchFormatText;
+        } else if(opt == 'f' && strcmp(optarg, "csv") == 0) {
+            format = BenchFormatCsv;
+        } else if(opt == 'f' && strcmp(optarg, "json") == 0) {
+            format = BenchFormatJson;
+        } else if(opt != 's' || !bench_parse_sizes(optarg)) {
+            fprintf(stderr, "usage: %s [-f text|csv|json] [-s size,size,...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    mkdir(BENCH_DIR, 0755);
+    storage_host_map("/data/", BENCH_DIR);
+    storage_host_map("/assets/", BENCH_DIR "/missing");
+
+    for(uint32_t s = 0; s < bench_size_count; s++) {
+        bench_run(bench_sizes[s], bench_results[s]);
+    }
+
+    if(format == BenchFormatCsv) {
+        bench_print_csv();
+    } else if(format == BenchFormatJson) {
+        bench_print_json();
+    } else {
+        bench_print_text();
+    }
+    return 0;
+}
@@ -0,0 +1,1077 @@
+// Host-side builder for the .dict images described in dictionary_format.h
+#include "dictionary_compiler.h"
+#include "dictionary_dawg_builder.h"
+#include "dictionary_encoder.h"
+#include "dictionary_fold.h"
+#include "dictionary_format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Bytes of input held in memory while sorting; larger inputs are sorted in
+// runs of this size spilled to temporary files, then merged
+#ifndef COMPILER_RUN_BUDGET
+#define COMPILER_RUN_BUDGET (64u << 20)
+#endif
+
+typedef struct {
+    const char* word;
+    const char* definition;
+    const char* translation;
+    uint32_t frequency; // From the input, 0 if not given
+} CompilerEntry;
+
+// Sorted, deduplicated entries. The strings live in a temporary file mapped
+// into memory, so only the entry table itself is on the heap.
+typedef struct {
+    CompilerEntry* entries;
+    uint32_t count;
+    uint32_t max_text_length;
+    uint32_t duplicate_count; // Entries dropped for repeating an earlier word
+    bool has_frequencies;     // Some line gave a frequency
+    void* map;
+    size_t map_size;
+} CompilerInput;
+
+// Growable byte buffer used to assemble sections. With file set, the bytes
+// are written straight to the file instead and only counted.
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    FILE* file;
+    bool failed;     // A write to file failed
+    uint64_t offset; // Of the section in the image
+} CompilerBuffer;
+
+static void compiler_buffer_append(CompilerBuffer* buffer, const void* data, size_t size) {
+    if(buffer->file != NULL) {
+        if(fwrite(data, 1, size, buffer->file) != size) {
+            buffer->failed = true;
+        }
+        buffer->size += size;
+        return;
+    }
+    if(buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while(capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+        buffer->data = realloc(buffer->data, capacity);
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static uint32_t compiler_buffer_append_string(CompilerBuffer* buffer, const char* string) {
+    uint32_t offset = buffer->size;
+    compiler_buffer_append(buffer, string, strlen(string) + 1);
+    return offset;
+}
+
+static void compiler_buffer_free(CompilerBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+static void compiler_input_free(CompilerInput* input) {
+    free(input->entries);
+    if(input->map != NULL) {
+        munmap(input->map, input->map_size);
+    }
+}
+
+// An input line waiting to be sorted: "word\0definition\0translation\0"
+// at offset in the run buffer
+typedef struct {
+    uint32_t line; // Input order, the first of several equal words wins
+    uint32_t size;
+    size_t offset;
+} CompilerRecord;
+
+// The input lines read so far that were not spilled yet
+typedef struct {
+    CompilerBuffer data;
+    CompilerRecord* records;
+    uint32_t count;
+    uint32_t capacity;
+} CompilerRun;
+
+static const char* compiler_sort_base;
+
+static int compiler_compare_records(const void* a, const void* b) {
+    const CompilerRecord* record_a = a;
+    const CompilerRecord* record_b = b;
+    int result = strcmp(compiler_sort_base + record_a->offset, compiler_sort_base + record_b->offset);
+    if(result != 0) return result;
+    return record_a->line < record_b->line ? -1 : (record_a->line > record_b->line);
+}
+
+// Check that a string is well-formed UTF-8: no stray continuation bytes,
+// overlong forms, surrogates or code points past U+10FFFF
+static bool compiler_is_utf8(const char* text) {
+    const uint8_t* in = (const uint8_t*)text;
+    while(*in != '\0') {
+        uint8_t first = *in++;
+        if(first < 0x80) continue;
+
+        uint8_t size;
+        uint32_t code;
+        if(first >= 0xc2 && first <= 0xdf) {
+            size = 1;
+            code = first & 0x1f;
+        } else if(first >= 0xe0 && first <= 0xef) {
+            size = 2;
+            code = first & 0x0f;
+        } else if(first >= 0xf0 && first <= 0xf4) {
+            size = 3;
+            code = first & 0x07;
+        } else {
+            return false;
+        }
+        for(uint8_t i = 0; i < size; i++) {
+            if((*in & 0xc0) != 0x80) return false;
+            code = (code << 6) | (*in++ & 0x3f);
+        }
+        if((size == 2 && (code < 0x800 || (code >= 0xd800 && code <= 0xdfff))) ||
+           (size == 3 && (code < 0x10000 || code > 0x10ffff))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parse one "word<TAB>definition<TAB>translation[<TAB>frequency]" line in
+// place, a missing frequency is left empty
+static bool compiler_parse_tsv(char* line, char** fields) {
+    fields[3] = line + strlen(line);
+    for(uint8_t i = 0; i < 4; i++) {
+        fields[i] = line;
+        char* end = strchr(line, '\t');
+        if(end == NULL) return i >= 2;
+        if(i == 3) return false;
+        *end = '\0';
+        line = end + 1;
+    }
+    return true;
+}
+
+// Parse one "word,definition,translation[,frequency]" line in place. Fields
+// may be quoted to hold commas, with "" for a quote; they can't span lines.
+static bool compiler_parse_csv(char* line, char** fields) {
+    char* in = line;
+    fields[3] = line + strlen(line);
+    for(uint8_t i = 0; i < 4; i++) {
+        char* out = in;
+        fields[i] = out;
+        if(*in == '"') {
+            in++;
+            while(!(in[0] == '"' && in[1] != '"')) {
+                if(*in == '\0') return false;
+                if(*in == '"') in++;
+                *out++ = *in++;
+            }
+            in++;
+        } else {
+            while(*in != ',' && *in != '\0') {
+                if(*in == '"') return false;
+                *out++ = *in++;
+            }
+        }
+
+        bool end = *in == '\0';
+        if(!end && *in != ',') return false;
+        in++;
+        *out = '\0';
+        if(end) return i >= 2;
+    }
+    return false;
+}
+
+// Check that a frequency is empty or a decimal count that fits 32 bits
+static bool compiler_is_frequency(const char* text) {
+    size_t length = strlen(text);
+    if(length > 10) return false;
+    for(size_t i = 0; i < length; i++) {
+        if(text[i] < '0' || text[i] > '9') return false;
+    }
+    return strtoull(text, NULL, 10) <= UINT32_MAX;
+}
+
+// Sort the run and append it to a temporary file as records of
+// line, size and the four strings
+static bool compiler_spill_run(CompilerRun* run, FILE** files, uint32_t* file_count) {
+    if(run->count == 0) return true;
+
+    compiler_sort_base = (const char*)run->data.data;
+    qsort(run->records, run->count, sizeof(CompilerRecord), compiler_compare_records);
+
+    FILE* file = tmpfile();
+    if(file == NULL) {
+        perror("tmpfile");
+        return false;
+    }
+    for(uint32_t i = 0; i < run->count; i++) {
+        const CompilerRecord* record = &run->records[i];
+        fwrite(&record->line, sizeof(record->line), 1, file);
+        fwrite(&record->size, sizeof(record->size), 1, file);
+        fwrite(run->data.data + record->offset, 1, record->size, file);
+    }
+    if(fflush(file) != 0 || ferror(file)) {
+        perror("tmpfile");
+        fclose(file);
+        return false;
+    }
+    rewind(file);
+
+    files[(*file_count)++] = file;
+    run->count = 0;
+    run->data.size = 0;
+    return true;
+}
+
+// Read the input into sorted runs on temporary files
+static bool compiler_read_runs(
+    const char* path,
+    CompilerInput* input,
+    FILE*** files,
+    uint32_t* file_count) {
+    FILE* file = fopen(path, "r");
+    if(file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    size_t path_length = strlen(path);
+    bool csv = path_length > 4 && strcmp(path + path_length - 4, ".csv") == 0;
+
+    CompilerRun run = {0};
+    uint32_t file_capacity = 0;
+    char* line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    uint32_t line_number = 0;
+    bool ok = true;
+
+    while(ok && (length = getline(&line, &line_capacity, file)) >= 0) {
+        line_number++;
+        while(length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if(length == 0 || line[0] == '#') continue;
+
+        char* fields[4];
+        if(!(csv ? compiler_parse_csv(line, fields) : compiler_parse_tsv(line, fields)) || fields[0][0] == '\0') {
+            fprintf(
+                stderr,
+                "%s:%u: expected %s\n",
+                path,
+                line_number,
+                csv ? "word,definition,translation[,frequency]" :
+                      "word<TAB>definition<TAB>translation[<TAB>frequency]");
+            ok = false;
+            break;
+        }
+        if(!compiler_is_frequency(fields[3])) {
+            fprintf(stderr, "%s:%u: frequency is not a 32-bit count\n", path, line_number);
+            ok = false;
+            break;
+        }
+        if(fields[3][0] != '\0') {
+            input->has_frequencies = true;
+        }
+        if(strlen(fields[0]) > DICTIONARY_WORD_MAX) {
+            fprintf(stderr, "%s:%u: word longer than %d bytes\n", path, line_number, DICTIONARY_WORD_MAX);
+            ok = false;
+            break;
+        }
+        uint32_t size = 0;
+        for(uint8_t i = 0; i < 3; i++) {
+            size_t field_length = strlen(fields[i]);
+            if(!compiler_is_utf8(fields[i])) {
+                fprintf(stderr, "%s:%u: invalid UTF-8\n", path, line_number);
+                ok = false;
+            } else if(i > 0 && field_length > DICTIONARY_TEXT_MAX) {
+                fprintf(stderr, "%s:%u: text longer than %d bytes\n", path, line_number, DICTIONARY_TEXT_MAX);
+                ok = false;
+            }
+            if(i > 0 && field_length > input->max_text_length) {
+                input->max_text_length = field_length;
+            }
+            size += field_length + 1;
+        }
+        size += strlen(fields[3]) + 1;
+        if(!ok) break;
+
+        // Keep the run within its budget, the records count against it too
+        if(run.data.size + size + (run.count + 1) * sizeof(CompilerRecord) > COMPILER_RUN_BUDGET) {
+            if(*file_count == file_capacity) {
+                file_capacity = file_capacity ? file_capacity * 2 : 16;
+                *files = realloc(*files, file_capacity * sizeof(FILE*));
+            }
+            ok = compiler_spill_run(&run, *files, file_count);
+            if(!ok) break;
+        }
+
+        if(run.count == run.capacity) {
+            run.capacity = run.capacity ? run.capacity * 2 : 1024;
+            run.records = realloc(run.records, run.capacity * sizeof(CompilerRecord));
+        }
+        CompilerRecord* record = &run.records[run.count++];
+        record->line = line_number;
+        record->size = size;
+        record->offset = run.data.size;
+        for(uint8_t i = 0; i < 4; i++) {
+            compiler_buffer_append_string(&run.data, fields[i]);
+        }
+    }
+
+    if(ok) {
+        if(*file_count == file_capacity) {
+            *files = realloc(*files, (file_capacity + 1) * sizeof(FILE*));
+        }
+        ok = compiler_spill_run(&run, *files, file_count);
+    }
+
+    free(run.records);
+    compiler_buffer_free(&run.data);
+    free(line);
+    fclose(file);
+    return ok;
+}
+
+// The next record of a run being merged
+typedef struct {
+    FILE* file;
+    uint32_t line;
+    uint32_t size;
+    char* data;
+    uint32_t capacity;
+} CompilerMergeRun;
+
+static bool compiler_merge_next(CompilerMergeRun* run) {
+    if(fread(&run->line, sizeof(run->line), 1, run->file) != 1 ||
+       fread(&run->size, sizeof(run->size), 1, run->file) != 1) {
+        return false;
+    }
+    if(run->size > run->capacity) {
+        run->capacity = run->size;
+        run->data = realloc(run->data, run->capacity);
+    }
+    return fread(run->data, 1, run->size, run->file) == run->size;
+}
+
+static bool compiler_merge_less(const CompilerMergeRun* a, const CompilerMergeRun* b) {
+    int result = strcmp(a->data, b->data);
+    return result < 0 || (result == 0 && a->line < b->line);
+}
+
+// Restore the heap order below position
+static void compiler_merge_sift(CompilerMergeRun** heap, uint32_t count, uint32_t position) {
+    for(;;) {
+        uint32_t smallest = position;
+        uint32_t left = 2 * position + 1;
+        if(left < count && compiler_merge_less(heap[left], heap[smallest])) smallest = left;
+        if(left + 1 < count && compiler_merge_less(heap[left + 1], heap[smallest])) smallest = left + 1;
+        if(smallest == position) return;
+        CompilerMergeRun* swap = heap[position];
+        heap[position] = heap[smallest];
+        heap[smallest] = swap;
+        position = smallest;
+    }
+}
+
+// Merge the sorted runs into one temporary file of unique entries
+static FILE* compiler_merge_runs(FILE** files, uint32_t file_count, CompilerInput* input) {
+    FILE* output = tmpfile();
+    if(output == NULL) {
+        perror("tmpfile");
+        return NULL;
+    }
+
+    CompilerMergeRun* runs = calloc(file_count, sizeof(CompilerMergeRun));
+    CompilerMergeRun** heap = malloc(file_count * sizeof(CompilerMergeRun*));
+    uint32_t heap_count = 0;
+    for(uint32_t i = 0; i < file_count; i++) {
+        runs[i].file = files[i];
+        if(compiler_merge_next(&runs[i])) {
+            heap[heap_count++] = &runs[i];
+        }
+    }
+    for(uint32_t i = heap_count / 2; i-- > 0;) {
+        compiler_merge_sift(heap, heap_count, i);
+    }
+
+    // Lines with the same word come out together, first in input order
+    char previous[DICTIONARY_WORD_MAX + 1] = "";
+    while(heap_count > 0) {
+        CompilerMergeRun* run = heap[0];
+        if(input->count > 0 && strcmp(run->data, previous) == 0) {
+            input->duplicate_count++;
+        } else {
+            fwrite(run->data, 1, run->size, output);
+            strcpy(previous, run->data);
+            input->count++;
+        }
+
+        if(!compiler_merge_next(run)) {
+            heap[0] = heap[--heap_count];
+        }
+        compiler_merge_sift(heap, heap_count, 0);
+    }
+
+    for(uint32_t i = 0; i < file_count; i++) {
+        free(runs[i].data);
+    }
+    free(runs);
+    free(heap);
+
+    if(fflush(output) != 0 || ferror(output)) {
+        perror("tmpfile");
+        fclose(output);
+        return NULL;
+    }
+    return output;
+}
+
+// Read, validate, sort and deduplicate the input
+static bool compiler_read_input(const char* path, CompilerInput* input) {
+    FILE** files = NULL;
+    uint32_t file_count = 0;
+    FILE* merged = NULL;
+
+    bool ok = compiler_read_runs(path, input, &files, &file_count);
+    if(ok) {
+        merged = compiler_merge_runs(files, file_count, input);
+        ok = merged != NULL;
+    }
+    for(uint32_t i = 0; i < file_count; i++) {
+        fclose(files[i]);
+    }
+    free(files);
+
+    // Point the entries into the merged file
+    if(ok && input->count > 0) {
+        input->map_size = ftell(merged);
+        input->map = mmap(NULL, input->map_size, PROT_READ, MAP_PRIVATE, fileno(merged), 0);
+        if(input->map == MAP_FAILED) {
+            perror("mmap");
+            input->map = NULL;
+            ok = false;
+        }
+    }
+    if(ok && input->count > 0) {
+        input->entries = malloc(input->count * sizeof(CompilerEntry));
+        const char* text = input->map;
+        for(uint32_t i = 0; i < input->count; i++) {
+            CompilerEntry* entry = &input->entries[i];
+            entry->word = text;
+            text += strlen(text) + 1;
+            entry->definition = text;
+            text += strlen(text) + 1;
+            entry->translation = text;
+            text += strlen(text) + 1;
+            entry->frequency = strtoul(text, NULL, 10);
+            text += strlen(text) + 1;
+        }
+    }
+    if(merged != NULL) {
+        // The mapping keeps the data after the file is closed
+        fclose(merged);
+    }
+    if(!ok) {
+        input->count = 0;
+    }
+    return ok;
+}
+
+// Front-code the words in blocks and index the start of each block
+static void compiler_build_words(
+    const CompilerInput* input,
+    CompilerBuffer* index,
+    CompilerBuffer* data,
+    DictionaryCompilerStats* stats) {
+    stats->word_size = 0;
+    for(uint32_t i = 0; i < input->count; i++) {
+        const char* word = input->entries[i].word;
+        stats->word_size += strlen(word) + 1 + sizeof(uint32_t);
+
+        if(i % DICTIONARY_WORD_BLOCK_ENTRIES == 0) {
+            uint32_t offset = compiler_buffer_append_string(data, word);
+            compiler_buffer_append(index, &offset, sizeof(offset));
+            continue;
+        }
+
+        const char* previous = input->entries[i - 1].word;
+        uint8_t shared = 0;
+        while(previous[shared] != '\0' && previous[shared] == word[shared]) {
+            shared++;
+        }
+        compiler_buffer_append(data, &shared, sizeof(shared));
+        compiler_buffer_append_string(data, word + shared);
+    }
+
+    // Closing offset marks the end of the last block
+    uint32_t end = data->size;
+    compiler_buffer_append(index, &end, sizeof(end));
+    stats->packed_word_size = index->size + data->size;
+}
+
+// Build the DAWG over the words for prefix search
+static void compiler_build_dawg(const CompilerInput* input, CompilerBuffer* dawg, DictionaryCompilerStats* stats) {
+    DictionaryDawgBuilder* builder = dictionary_dawg_builder_alloc();
+    for(uint32_t i = 0; i < input->count; i++) {
+        dictionary_dawg_builder_add(builder, input->entries[i].word);
+    }
+
+    uint8_t* section;
+    size_t size = dictionary_dawg_builder_finish(builder, &section);
+    compiler_buffer_append(dawg, section, size);
+
+    DictionaryFileDawgHeader header;
+    memcpy(&header, section, sizeof(header));
+    stats->dawg_size = size;
+    stats->dawg_node_count = header.node_count;
+
+    free(section);
+    dictionary_dawg_builder_free(builder);
+}
+
+// A translation alternative and the offset of its folded key, for sorting
+typedef struct {
+    size_t key;
+    DictionaryFileReverseRecord record;
+} CompilerReverseKey;
+
+static int compiler_compare_reverse(const void* a, const void* b) {
+    const CompilerReverseKey* key_a = a;
+    const CompilerReverseKey* key_b = b;
+    int result = strcmp(compiler_sort_base + key_a->key, compiler_sort_base + key_b->key);
+    if(result != 0) return result;
+    if(key_a->record.entry != key_b->record.entry) {
+        return key_a->record.entry < key_b->record.entry ? -1 : 1;
+    }
+    return key_a->record.offset < key_b->record.offset ? -1 : (key_a->record.offset > key_b->record.offset);
+}
+
+// Index every translation alternative by its folded key
+static void compiler_build_reverse(const CompilerInput* input, CompilerBuffer* reverse, DictionaryCompilerStats* stats) {
+    CompilerReverseKey* keys = NULL;
+    CompilerBuffer strings = {0};
+    size_t count = 0;
+    size_t capacity = 0;
+    char key[DICTIONARY_FOLD_KEY_MAX + 1];
+
+    for(uint32_t i = 0; i < input->count; i++) {
+        const char* translation = input->entries[i].translation;
+        size_t offset = 0;
+        while(translation[offset] != '\0') {
+            // Alternatives start after a separator and any spaces
+            while(translation[offset] == ' ' || dictionary_fold_is_separator(translation[offset])) {
+                offset++;
+            }
+            if(translation[offset] == '\0') break;
+
+            if(dictionary_fold_key(translation + offset, key) > 0) {
+                if(count == capacity) {
+                    capacity = capacity ? capacity * 2 : 1024;
+                    keys = realloc(keys, capacity * sizeof(CompilerReverseKey));
+                }
+                keys[count].key = strings.size;
+                keys[count].record.entry = i;
+                keys[count].record.offset = offset;
+                compiler_buffer_append_string(&strings, key);
+                count++;
+            }
+
+            while(translation[offset] != '\0' && !dictionary_fold_is_separator(translation[offset])) {
+                offset++;
+            }
+        }
+    }
+
+    compiler_sort_base = (const char*)strings.data;
+    qsort(keys, count, sizeof(CompilerReverseKey), compiler_compare_reverse);
+    for(size_t i = 0; i < count; i++) {
+        compiler_buffer_append(reverse, &keys[i].record, sizeof(DictionaryFileReverseRecord));
+    }
+    free(keys);
+    compiler_buffer_free(&strings);
+    stats->reverse_count = count;
+}
+
+// Record where the words starting with each byte begin
+static void compiler_build_letters(const CompilerInput* input, CompilerBuffer* letters) {
+    uint32_t index = 0;
+    for(uint32_t letter = 0; letter < DICTIONARY_LETTER_COUNT; letter++) {
+        while(index < input->count && (uint8_t)input->entries[index].word[0] < letter) {
+            index++;
+        }
+        compiler_buffer_append(letters, &index, sizeof(index));
+    }
+}
+
+// Record where the words starting with each byte and letter begin, for the
+// bytes some word starts with
+static void compiler_build_bigrams(const CompilerInput* input, CompilerBuffer* bigrams) {
+    uint16_t rows[DICTIONARY_BIGRAM_ROWS] = {0};
+    CompilerBuffer columns = {0};
+    uint16_t row_count = 0;
+    uint32_t index = 0;
+    for(uint32_t first = 0; first < DICTIONARY_BIGRAM_ROWS; first++) {
+        if(index == input->count || (uint8_t)input->entries[index].word[0] != first) continue;
+
+        rows[first] = row_count++;
+        for(uint32_t column = 0; column < DICTIONARY_BIGRAM_COLUMNS; column++) {
+            uint8_t second = 'a' + column;
+            while(index < input->count) {
+                const uint8_t* word = (const uint8_t*)input->entries[index].word;
+                if(word[0] > first || (word[0] == first && word[1] >= second)) break;
+                index++;
+            }
+            compiler_buffer_append(&columns, &index, sizeof(index));
+        }
+
+        // The rest of the bucket
+        while(index < input->count && (uint8_t)input->entries[index].word[0] == first) {
+            index++;
+        }
+    }
+    compiler_buffer_append(bigrams, rows, sizeof(rows));
+    if(row_count > 0) {
+        compiler_buffer_append(bigrams, columns.data, columns.size);
+    }
+    compiler_buffer_free(&columns);
+}
+
+// A definition word and the entries it appears in
+typedef struct {
+    char* term;
+    uint32_t* entries;
+    uint32_t count;
+    uint32_t capacity;
+} CompilerTerm;
+
+// Definition words by name, open addressing
+typedef struct {
+    CompilerTerm* slots;
+    uint32_t capacity;
+    uint32_t count;
+} CompilerTermTable;
+
+static uint32_t compiler_hash_term(const char* term) {
+    uint32_t hash = 2166136261u;
+    while(*term != '\0') {
+        hash = (hash ^ (uint8_t)*term++) * 16777619u;
+    }
+    return hash;
+}
+
+static CompilerTerm* compiler_find_term(CompilerTermTable* table, const char* term) {
+    if((table->count + 1) * 2 > table->capacity) {
+        uint32_t capacity = table->capacity ? table->capacity * 2 : 4096;
+        CompilerTerm* slots = calloc(capacity, sizeof(CompilerTerm));
+        for(uint32_t i = 0; i < table->capacity; i++) {
+            if(table->slots[i].term == NULL) continue;
+            uint32_t slot = compiler_hash_term(table->slots[i].term) & (capacity - 1);
+            while(slots[slot].term != NULL) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            slots[slot] = table->slots[i];
+        }
+        free(table->slots);
+        table->slots = slots;
+        table->capacity = capacity;
+    }
+
+    uint32_t slot = compiler_hash_term(term) & (table->capacity - 1);
+    while(table->slots[slot].term != NULL) {
+        if(strcmp(table->slots[slot].term, term) == 0) return &table->slots[slot];
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    table->slots[slot].term = strdup(term);
+    table->count++;
+    return &table->slots[slot];
+}
+
+static int compiler_compare_terms(const void* a, const void* b) {
+    return strcmp(((const CompilerTerm*)a)->term, ((const CompilerTerm*)b)->term);
+}
+
+static void compiler_append_varint(CompilerBuffer* buffer, uint32_t value) {
+    uint8_t bytes[5];
+    size_t size = 0;
+    while(value >= 0x80) {
+        bytes[size++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    bytes[size++] = value;
+    compiler_buffer_append(buffer, bytes, size);
+}
+
+// Count the definitions that use a word, or UINT32_MAX for a word too
+// common to be indexed. Words that are not a single full-text word get 0.
+static uint32_t compiler_count_usage(const char* word, const CompilerTerm* terms, uint32_t count) {
+    char token[DICTIONARY_FOLD_TOKEN_MAX + 1];
+    size_t length = strlen(word);
+    if(length > DICTIONARY_FOLD_TOKEN_MAX) return 0;
+    for(size_t i = 0; i <= length; i++) {
+        char c = word[i];
+        if(c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        } else if(c != '\0' && !((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+            return 0;
+        }
+        token[i] = c;
+    }
+    if(dictionary_fold_is_stopword(token)) return UINT32_MAX;
+
+    CompilerTerm key = {.term = token};
+    const CompilerTerm* term = bsearch(&key, terms, count, sizeof(CompilerTerm), compiler_compare_terms);
+    return term != NULL ? term->count : 0;
+}
+
+// Build the inverted index of the definition words, and count how many
+// definitions use each entry's word
+static void compiler_build_terms(
+    const CompilerInput* input,
+    CompilerBuffer* terms,
+    CompilerBuffer* strings,
+    CompilerBuffer* postings,
+    uint32_t* usage,
+    DictionaryCompilerStats* stats) {
+    CompilerTermTable table = {0};
+    char token[DICTIONARY_FOLD_TOKEN_MAX + 1];
+
+    for(uint32_t i = 0; i < input->count; i++) {
+        const char* text = input->entries[i].definition;
+        while(dictionary_fold_next_token(&text, token) > 0) {
+            CompilerTerm* term = compiler_find_term(&table, token);
+
+            // Entries arrive in order, so a repeated word is the last posting
+            if(term->count > 0 && term->entries[term->count - 1] == i) continue;
+            if(term->count == term->capacity) {
+                term->capacity = term->capacity ? term->capacity * 2 : 4;
+                term->entries = realloc(term->entries, term->capacity * sizeof(uint32_t));
+            }
+            term->entries[term->count++] = i;
+            stats->posting_count++;
+        }
+    }
+
+    // Pack the terms to the front of the table and sort them
+    uint32_t count = 0;
+    for(uint32_t i = 0; i < table.capacity; i++) {
+        if(table.slots[i].term != NULL) {
+            table.slots[count++] = table.slots[i];
+        }
+    }
+    qsort(table.slots, count, sizeof(CompilerTerm), compiler_compare_terms);
+    for(uint32_t i = 0; i < input->count; i++) {
+        usage[i] = compiler_count_usage(input->entries[i].word, table.slots, count);
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        CompilerTerm* term = &table.slots[i];
+        DictionaryFileTerm record = {
+            .string_offset = compiler_buffer_append_string(strings, term->term),
+            .postings_offset = postings->size,
+            .count = term->count,
+        };
+        compiler_buffer_append(terms, &record, sizeof(record));
+
+        uint32_t previous = 0;
+        for(uint32_t p = 0; p < term->count; p++) {
+            compiler_append_varint(postings, term->entries[p] - previous);
+            previous = term->entries[p];
+        }
+
+        free(term->term);
+        free(term->entries);
+    }
+
+    // Closing record marks the end of the last term
+    DictionaryFileTerm end = {.string_offset = strings->size, .postings_offset = postings->size, .count = 0};
+    compiler_buffer_append(terms, &end, sizeof(end));
+
+    stats->term_count = count;
+    stats->fulltext_size = terms->size + strings->size + postings->size;
+    free(table.slots);
+}
+
+// Map a count to a rank that grows with its logarithm, eight steps per
+// doubling, 0 for a count of 0
+static uint8_t compiler_rank(uint32_t count) {
+    if(count == 0) return 0;
+    uint8_t bits = 0;
+    while((count >> bits) > 1) {
+        bits++;
+    }
+    uint32_t fraction = bits >= 3 ? (count >> (bits - 3)) & 7 : (count << (3 - bits)) & 7;
+    uint32_t rank = 1 + bits * 8 + fraction;
+    return rank > UINT8_MAX ? UINT8_MAX : rank;
+}
+
+// Rank the entries by the frequencies from the input, or without any by how
+// many definitions use their word, and add the tiers of maxima
+static void compiler_build_ranks(
+    const CompilerInput* input,
+    const uint32_t* usage,
+    CompilerBuffer* ranks,
+    DictionaryCompilerStats* stats) {
+    for(uint32_t i = 0; i < input->count; i++) {
+        uint8_t rank = compiler_rank(input->has_frequencies ? input->entries[i].frequency : usage[i]);
+        compiler_buffer_append(ranks, &rank, 1);
+        if(rank > 0) {
+            stats->ranked_count++;
+        }
+    }
+
+    size_t tier = 0;
+    size_t length = input->count;
+    while(length > 1) {
+        for(size_t i = 0; i < length; i += DICTIONARY_RANK_FANOUT) {
+            uint8_t max = 0;
+            for(size_t j = i; j < i + DICTIONARY_RANK_FANOUT && j < length; j++) {
+                if(ranks->data[tier + j] > max) {
+                    max = ranks->data[tier + j];
+                }
+            }
+            compiler_buffer_append(ranks, &max, 1);
+        }
+        tier += length;
+        length = (length + DICTIONARY_RANK_FANOUT - 1) / DICTIONARY_RANK_FANOUT;
+    }
+}
+
+// Compress the definitions and translations into blocks and build their index
+static void compiler_build_text(
+    const CompilerInput* input,
+    CompilerBuffer* codec,
+    CompilerBuffer* index,
+    CompilerBuffer* data,
+    DictionaryCompilerStats* stats) {
+    DictionaryEncoder* encoder = dictionary_encoder_alloc();
+    for(uint32_t i = 0; i < input->count; i++) {
+        dictionary_encoder_train(encoder, input->entries[i].definition);
+        dictionary_encoder_train(encoder, input->entries[i].translation);
+    }
+    dictionary_encoder_build_phrases(encoder, DICTIONARY_CODEC_PHRASES_MAX);
+
+    // Group consecutive entries into blocks, two passes: count then encode
+    CompilerBuffer block = {0};
+    uint8_t* packed = malloc(dictionary_encoder_bound(DICTIONARY_TEXT_BLOCK_SIZE));
+    size_t max_packed_size = 0;
+    stats->text_size = 0;
+
+    for(uint8_t pass = 0; pass < 2; pass++) {
+        uint32_t first_entry = 0;
+        block.size = 0;
+        for(uint32_t i = 0; i <= input->count; i++) {
+            size_t entry_size = 0;
+            if(i < input->count) {
+                entry_size = strlen(input->entries[i].definition) + strlen(input->entries[i].translation) + 2;
+            }
+
+            // Close the block when the next entry would overflow it or at the end
+            if(block.size > 0 && (i == input->count || block.size + entry_size > DICTIONARY_TEXT_BLOCK_SIZE)) {
+                if(pass == 0) {
+                    dictionary_encoder_count(encoder, block.data, block.size);
+                } else {
+                    size_t packed_size = dictionary_encoder_encode(encoder, block.data, block.size, packed);
+                    DictionaryFileTextBlock record = {.first_entry = first_entry, .offset = data->size};
+                    compiler_buffer_append(index, &record, sizeof(record));
+                    compiler_buffer_append(data, packed, packed_size);
+                    if(packed_size > max_packed_size) {
+                        max_packed_size = packed_size;
+                    }
+                    stats->text_size += block.size;
+                }
+                first_entry = i;
+                block.size = 0;
+            }
+
+            if(i < input->count) {
+                compiler_buffer_append_string(&block, input->entries[i].definition);
+                compiler_buffer_append_string(&block, input->entries[i].translation);
+            }
+        }
+
+        if(pass == 0) {
+            dictionary_encoder_build_code(encoder);
+        }
+    }
+
+    // Closing record marks the end of the last block
+    DictionaryFileTextBlock end = {.first_entry = input->count, .offset = data->size};
+    compiler_buffer_append(index, &end, sizeof(end));
+
+    size_t codec_size = dictionary_encoder_codec_size(encoder);
+    uint8_t* codec_data = malloc(codec_size);
+    dictionary_encoder_write_codec(encoder, max_packed_size, codec_data);
+    compiler_buffer_append(codec, codec_data, codec_size);
+    stats->packed_text_size = codec->size + index->size + data->size;
+
+    free(codec_data);
+    free(packed);
+    compiler_buffer_free(&block);
+    dictionary_encoder_free(encoder);
+}
+
+static bool compiler_write_image(const char* path, const CompilerInput* input, DictionaryCompilerStats* stats) {
+    FILE* file = fopen(path, "wb");
+    if(file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    // The largest sections go straight to the file as they are built, each
+    // in one piece, the others are held until they are done
+    CompilerBuffer word_index = {0};
+    CompilerBuffer word_data = {.file = file};
+    CompilerBuffer codec = {0};
+    CompilerBuffer text_index = {0};
+    CompilerBuffer text_data = {.file = file};
+    CompilerBuffer dawg = {0};
+    CompilerBuffer reverse = {0};
+    CompilerBuffer terms = {0};
+    CompilerBuffer term_strings = {0};
+    CompilerBuffer postings = {.file = file};
+    CompilerBuffer letters = {0};
+    CompilerBuffer ranks = {0};
+    CompilerBuffer bigrams = {0};
+
+    CompilerBuffer* sections[] = {
+        &word_index,
+        &word_data,
+        &codec,
+        &text_index,
+        &text_data,
+        &dawg,
+        &reverse,
+        &terms,
+        &term_strings,
+        &postings,
+        &letters,
+        &ranks,
+        &bigrams,
+    };
+    const uint32_t section_ids[] = {
+        DictionarySectionWordIndex,
+        DictionarySectionWordData,
+        DictionarySectionCodec,
+        DictionarySectionTextIndex,
+        DictionarySectionTextData,
+        DictionarySectionDawg,
+        DictionarySectionReverse,
+        DictionarySectionTerms,
+        DictionarySectionTermStrings,
+        DictionarySectionPostings,
+        DictionarySectionLetters,
+        DictionarySectionRanks,
+        DictionarySectionBigrams,
+    };
+    const uint16_t section_count = sizeof(sections) / sizeof(sections[0]);
+
+    // Room for the header and section table, written once the offsets are known
+    DictionaryFileHeader header = {
+        .magic = DICTIONARY_FILE_MAGIC,
+        .version = DICTIONARY_FILE_VERSION,
+        .section_count = section_count,
+        .entry_count = input->count,
+        .flags = DICTIONARY_FILE_FLAG_SORTED,
+        .max_text_length = input->max_text_length,
+    };
+    CompilerBuffer table = {0};
+    compiler_buffer_append(&table, &header, sizeof(header));
+    for(uint16_t i = 0; i < section_count; i++) {
+        DictionaryFileSection section = {0};
+        compiler_buffer_append(&table, &section, sizeof(section));
+    }
+    bool ok = fwrite(table.data, 1, table.size, file) == table.size;
+    uint64_t offset = table.size;
+
+    uint32_t* usage = malloc((input->count ? input->count : 1) * sizeof(uint32_t));
+    word_data.offset = offset;
+    compiler_build_words(input, &word_index, &word_data, stats);
+    offset += word_data.size;
+    compiler_build_dawg(input, &dawg, stats);
+    compiler_build_reverse(input, &reverse, stats);
+    postings.offset = offset;
+    compiler_build_terms(input, &terms, &term_strings, &postings, usage, stats);
+    offset += postings.size;
+    compiler_build_ranks(input, usage, &ranks, stats);
+    free(usage);
+    text_data.offset = offset;
+    compiler_build_text(input, &codec, &text_index, &text_data, stats);
+    offset += text_data.size;
+    compiler_build_letters(input, &letters);
+    compiler_build_bigrams(input, &bigrams);
+
+    // Then the sections held in memory
+    for(uint16_t i = 0; i < section_count; i++) {
+        if(sections[i]->file != NULL) {
+            ok = ok && !sections[i]->failed;
+            continue;
+        }
+        sections[i]->offset = offset;
+        offset += sections[i]->size;
+        ok = ok && fwrite(sections[i]->data, 1, sections[i]->size, file) == sections[i]->size;
+    }
+
+    // Now the section table can be filled in
+    table.size = sizeof(header);
+    for(uint16_t i = 0; i < section_count; i++) {
+        DictionaryFileSection section = {
+            .id = section_ids[i],
+            .offset = sections[i]->offset,
+            .size = sections[i]->size,
+        };
+        compiler_buffer_append(&table, &section, sizeof(section));
+    }
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(table.data, 1, table.size, file) == table.size;
+    ok = (fclose(file) == 0) && ok;
+    if(!ok) perror(path);
+
+    if(ok && offset > UINT32_MAX) {
+        fprintf(stderr, "%s: image larger than 4 GiB\n", path);
+        ok = false;
+    }
+    if(!ok) {
+        remove(path);
+    }
+
+    stats->file_size = offset;
+    compiler_buffer_free(&table);
+    for(uint16_t i = 0; i < section_count; i++) {
+        compiler_buffer_free(sections[i]);
+    }
+    return ok;
+}
+
+bool dictionary_compiler_compile(
+    const char* input_path,
+    const char* output_path,
+    DictionaryCompilerStats* stats) {
+    DictionaryCompilerStats local_stats;
+    if(stats == NULL) {
+        stats = &local_stats;
+    }
+    memset(stats, 0, sizeof(DictionaryCompilerStats));
+
+    CompilerInput input = {0};
+    bool ok = compiler_read_input(input_path, &input);
+    stats->entry_count = input.count;
+    stats->duplicate_count = input.duplicate_count;
+    if(ok) {
+        ok = compiler_write_image(output_path, &input, stats);
+    }
+
+    compiler_input_free(&input);
+    return ok;
+}
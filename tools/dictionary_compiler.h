@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host-side builder for the .dict images described in dictionary_format.h
+
+typedef struct {
+    uint32_t entry_count;
+    uint32_t duplicate_count; // Input lines dropped for repeating an earlier word
+    uint32_t file_size;
+    uint32_t word_size;        // Words as NUL-terminated strings with an offset each
+    uint32_t packed_word_size; // Front-coded word blocks and their index
+    uint32_t dawg_size;        // DAWG section
+    uint32_t dawg_node_count;
+    uint32_t reverse_count; // Translation alternatives in the reverse index
+    uint32_t term_count;    // Distinct definition words in the full-text index
+    uint32_t posting_count; // Entries listed under those words
+    uint32_t fulltext_size; // Terms, their strings and the posting lists
+    uint32_t ranked_count;  // Entries with a frequency rank above 0
+    uint32_t text_size;        // Definitions and translations before compression
+    uint32_t packed_text_size; // Compressed blocks, their index and the codec tables
+} DictionaryCompilerStats;
+
+// Compile a "word<TAB>definition<TAB>translation[<TAB>frequency]" file, or a
+// "word,definition,translation[,frequency]" one if its name ends in ".csv"
+// (fields may be quoted, with "" for a quote). The optional frequency is a
+// usage count for ranking completions; if no line has one, words are ranked
+// by how many definitions use them. The lines may come in any order; they are
+// sorted in runs of bounded size on temporary files, and of several lines
+// with the same word only the first is kept. Blank lines and lines starting
+// with '#' are ignored. Prints the reason and returns false if the input is
+// invalid, including text that is not UTF-8.
+bool dictionary_compiler_compile(
+    const char* input_path,
+    const char* output_path,
+    DictionaryCompilerStats* stats);
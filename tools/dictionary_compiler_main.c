@@ -0,0 +1,45 @@
+// Command line front end for the dictionary compiler
+#include "dictionary_compiler.h"
+
+#include <stdio.h>
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s <input.tsv|input.csv> <output.dict>\n", argv[0]);
+        return 2;
+    }
+
+    DictionaryCompilerStats stats;
+    if(!dictionary_compiler_compile(argv[1], argv[2], &stats)) {
+        return 1;
+    }
+
+    printf("%s: %u entries, %u bytes\n", argv[2], stats.entry_count, stats.file_size);
+    if(stats.duplicate_count > 0) {
+        printf("skipped %u lines repeating an earlier word\n", stats.duplicate_count);
+    }
+    printf(
+        "words: %u bytes front-coded to %u (%.2fx)\n",
+        stats.word_size,
+        stats.packed_word_size,
+        stats.packed_word_size ? (double)stats.word_size / stats.packed_word_size : 0.0);
+    printf(
+        "dawg: %u nodes, %u bytes (%.2f bytes/word)\n",
+        stats.dawg_node_count,
+        stats.dawg_size,
+        stats.entry_count ? (double)stats.dawg_size / stats.entry_count : 0.0);
+    printf("reverse: %u translations indexed\n", stats.reverse_count);
+    printf(
+        "full text: %u words, %u postings, %u bytes (%.2f bytes/posting)\n",
+        stats.term_count,
+        stats.posting_count,
+        stats.fulltext_size,
+        stats.posting_count ? (double)stats.fulltext_size / stats.posting_count : 0.0);
+    printf("ranks: %u of %u words ranked by frequency\n", stats.ranked_count, stats.entry_count);
+    printf(
+        "text: %u bytes packed to %u (%.2fx)\n",
+        stats.text_size,
+        stats.packed_text_size,
+        stats.packed_text_size ? (double)stats.text_size / stats.packed_text_size : 0.0);
+    return 0;
+}
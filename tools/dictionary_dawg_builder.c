@@ -0,0 +1,244 @@
+// Incremental DAWG construction for sorted input (Daciuk et al., 2000)
+#include "dictionary_dawg_builder.h"
+#include "dictionary_format.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUILDER_NONE UINT32_MAX
+
+typedef struct {
+    uint8_t label;
+    uint32_t child;
+} BuilderEdge;
+
+typedef struct {
+    BuilderEdge* edges;
+    uint16_t edge_count;
+    uint16_t edge_capacity;
+    bool final;
+    uint32_t count;  // Words at or below the node, set when it is registered
+    uint32_t offset; // Offset in the section, set when it is written
+} BuilderNode;
+
+struct DictionaryDawgBuilder {
+    BuilderNode* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    uint32_t* free_nodes; // Nodes replaced by an equivalent registered one
+    uint32_t free_count;
+
+    // Registered nodes by contents, open addressing
+    uint32_t* table;
+    uint32_t table_capacity;
+    uint32_t table_count;
+
+    // Registered nodes in registration order, children before parents. Sized
+    // like nodes, a node is registered at most once.
+    uint32_t* order;
+    uint32_t order_count;
+
+    // Nodes along the previous word, path[0] is the root
+    uint32_t path[DICTIONARY_WORD_MAX + 2];
+    char previous[DICTIONARY_WORD_MAX + 1];
+};
+
+static uint32_t builder_new_node(DictionaryDawgBuilder* builder) {
+    uint32_t id;
+    if(builder->free_count > 0) {
+        id = builder->free_nodes[--builder->free_count];
+    } else {
+        if(builder->node_count == builder->node_capacity) {
+            builder->node_capacity = builder->node_capacity ? builder->node_capacity * 2 : 1024;
+            builder->nodes = realloc(builder->nodes, builder->node_capacity * sizeof(BuilderNode));
+            builder->free_nodes = realloc(builder->free_nodes, builder->node_capacity * sizeof(uint32_t));
+            builder->order = realloc(builder->order, builder->node_capacity * sizeof(uint32_t));
+        }
+        id = builder->node_count++;
+    }
+    memset(&builder->nodes[id], 0, sizeof(BuilderNode));
+    return id;
+}
+
+static void builder_add_edge(DictionaryDawgBuilder* builder, uint32_t id, uint8_t label, uint32_t child) {
+    BuilderNode* node = &builder->nodes[id];
+    if(node->edge_count == node->edge_capacity) {
+        node->edge_capacity = node->edge_capacity ? node->edge_capacity * 2 : 2;
+        node->edges = realloc(node->edges, node->edge_capacity * sizeof(BuilderEdge));
+    }
+    node->edges[node->edge_count].label = label;
+    node->edges[node->edge_count].child = child;
+    node->edge_count++;
+}
+
+static uint32_t builder_hash(const BuilderNode* node) {
+    uint32_t hash = 2166136261u ^ node->final;
+    for(uint16_t i = 0; i < node->edge_count; i++) {
+        hash = (hash ^ node->edges[i].label) * 16777619u;
+        hash = (hash ^ node->edges[i].child) * 16777619u;
+    }
+    return hash;
+}
+
+static bool builder_equal(const BuilderNode* a, const BuilderNode* b) {
+    if(a->final != b->final || a->edge_count != b->edge_count) return false;
+    for(uint16_t i = 0; i < a->edge_count; i++) {
+        if(a->edges[i].label != b->edges[i].label || a->edges[i].child != b->edges[i].child) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void builder_grow_table(DictionaryDawgBuilder* builder) {
+    uint32_t capacity = builder->table_capacity ? builder->table_capacity * 2 : 4096;
+    uint32_t* table = malloc(capacity * sizeof(uint32_t));
+    memset(table, 0xff, capacity * sizeof(uint32_t));
+
+    for(uint32_t i = 0; i < builder->table_capacity; i++) {
+        uint32_t id = builder->table[i];
+        if(id == BUILDER_NONE) continue;
+        uint32_t slot = builder_hash(&builder->nodes[id]) & (capacity - 1);
+        while(table[slot] != BUILDER_NONE) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        table[slot] = id;
+    }
+
+    free(builder->table);
+    builder->table = table;
+    builder->table_capacity = capacity;
+}
+
+// Return the registered node equivalent to a node, registering it if there is none
+static uint32_t builder_register(DictionaryDawgBuilder* builder, uint32_t id) {
+    if((builder->table_count + 1) * 2 > builder->table_capacity) {
+        builder_grow_table(builder);
+    }
+
+    BuilderNode* node = &builder->nodes[id];
+    uint32_t slot = builder_hash(node) & (builder->table_capacity - 1);
+    while(builder->table[slot] != BUILDER_NONE) {
+        uint32_t other = builder->table[slot];
+        if(builder_equal(&builder->nodes[other], node)) return other;
+        slot = (slot + 1) & (builder->table_capacity - 1);
+    }
+
+    node->count = node->final ? 1 : 0;
+    for(uint16_t i = 0; i < node->edge_count; i++) {
+        node->count += builder->nodes[node->edges[i].child].count;
+    }
+
+    builder->table[slot] = id;
+    builder->table_count++;
+    builder->order[builder->order_count++] = id;
+    return id;
+}
+
+// Minimize the nodes of the previous word below the given depth
+static void builder_minimize(DictionaryDawgBuilder* builder, size_t depth) {
+    for(size_t d = strlen(builder->previous); d > depth; d--) {
+        uint32_t id = builder->path[d];
+        uint32_t registered = builder_register(builder, id);
+        if(registered != id) {
+            BuilderNode* parent = &builder->nodes[builder->path[d - 1]];
+            parent->edges[parent->edge_count - 1].child = registered;
+            free(builder->nodes[id].edges);
+            builder->free_nodes[builder->free_count++] = id;
+        }
+    }
+}
+
+DictionaryDawgBuilder* dictionary_dawg_builder_alloc(void) {
+    DictionaryDawgBuilder* builder = calloc(1, sizeof(DictionaryDawgBuilder));
+    builder->path[0] = builder_new_node(builder);
+    return builder;
+}
+
+void dictionary_dawg_builder_free(DictionaryDawgBuilder* builder) {
+    // Freed nodes have had their edges released already
+    for(uint32_t i = 0; i < builder->free_count; i++) {
+        builder->nodes[builder->free_nodes[i]].edges = NULL;
+    }
+    for(uint32_t i = 0; i < builder->node_count; i++) {
+        free(builder->nodes[i].edges);
+    }
+    free(builder->nodes);
+    free(builder->free_nodes);
+    free(builder->table);
+    free(builder->order);
+    free(builder);
+}
+
+void dictionary_dawg_builder_add(DictionaryDawgBuilder* builder, const char* word) {
+    size_t common = 0;
+    while(word[common] != '\0' && word[common] == builder->previous[common]) {
+        common++;
+    }
+    builder_minimize(builder, common);
+
+    size_t length = strlen(word);
+    for(size_t d = common; d < length; d++) {
+        uint32_t child = builder_new_node(builder);
+        builder_add_edge(builder, builder->path[d], (uint8_t)word[d], child);
+        builder->path[d + 1] = child;
+    }
+    builder->nodes[builder->path[length]].final = true;
+
+    memcpy(builder->previous, word, length + 1);
+}
+
+static void builder_append_varint(uint8_t* data, size_t* size, uint32_t value) {
+    while(value >= 0x80) {
+        data[(*size)++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    data[(*size)++] = value;
+}
+
+size_t dictionary_dawg_builder_finish(DictionaryDawgBuilder* builder, uint8_t** section) {
+    builder_minimize(builder, 0);
+
+    // The root is never shared, append it without looking it up
+    uint32_t root = builder->path[0];
+    builder->order[builder->order_count++] = root;
+    BuilderNode* root_node = &builder->nodes[root];
+    root_node->count = root_node->final ? 1 : 0;
+    for(uint16_t i = 0; i < root_node->edge_count; i++) {
+        root_node->count += builder->nodes[root_node->edges[i].child].count;
+    }
+
+    // Worst case: edge count, then label and two 5-byte varints per edge
+    size_t capacity = sizeof(DictionaryFileDawgHeader);
+    for(uint32_t i = 0; i < builder->order_count; i++) {
+        capacity += 1 + builder->nodes[builder->order[i]].edge_count * 11;
+    }
+    uint8_t* data = malloc(capacity);
+    uint8_t* nodes = data + sizeof(DictionaryFileDawgHeader);
+    size_t size = 0;
+
+    for(uint32_t i = 0; i < builder->order_count; i++) {
+        BuilderNode* node = &builder->nodes[builder->order[i]];
+        node->offset = size;
+        nodes[size++] = node->edge_count;
+
+        uint32_t skip = node->final ? 1 : 0;
+        for(uint16_t e = 0; e < node->edge_count; e++) {
+            const BuilderNode* child = &builder->nodes[node->edges[e].child];
+            nodes[size++] = node->edges[e].label;
+            builder_append_varint(nodes, &size, skip);
+            builder_append_varint(nodes, &size, node->offset - child->offset);
+            skip += child->count;
+        }
+    }
+
+    DictionaryFileDawgHeader header = {
+        .root = builder->nodes[root].offset,
+        .node_count = builder->order_count,
+    };
+    memcpy(data, &header, sizeof(header));
+
+    *section = data;
+    return sizeof(header) + size;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// Host-side builder for the DAWG section in dictionary_format.h
+//
+// Words are added in strcmp() order and the automaton is minimized as it
+// grows, so only the nodes of the last word are held unminimized. The reader
+// lives in dictionary_dawg.c.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct DictionaryDawgBuilder DictionaryDawgBuilder;
+
+DictionaryDawgBuilder* dictionary_dawg_builder_alloc(void);
+void dictionary_dawg_builder_free(DictionaryDawgBuilder* builder);
+
+// Add a word, which must sort after the previous one
+void dictionary_dawg_builder_add(DictionaryDawgBuilder* builder, const char* word);
+
+// Minimize the last word and serialize the section into a new malloc()ed
+// buffer. Returns the size of the section.
+size_t dictionary_dawg_builder_finish(DictionaryDawgBuilder* builder, uint8_t** section);
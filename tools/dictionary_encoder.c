@@ -0,0 +1,406 @@
+// Host-side encoder for the compressed text blocks in dictionary_format.h
+#include "dictionary_encoder.h"
+#include "dictionary_format.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ENCODER_SYMBOLS_MAX (DICTIONARY_CODEC_LITERALS + DICTIONARY_CODEC_PHRASES_MAX)
+
+// Phrase candidate seen while training
+typedef struct {
+    uint8_t length; // 0 for an empty hash slot
+    char text[DICTIONARY_CODEC_PHRASE_MAX];
+    uint32_t count;
+} EncoderCandidate;
+
+// Trie over the chosen phrases, children are kept as sibling lists
+typedef struct {
+    int32_t child;
+    int32_t sibling;
+    int16_t phrase; // Phrase ending here, -1 if none
+    uint8_t byte;
+} EncoderTrieNode;
+
+struct DictionaryEncoder {
+    EncoderCandidate* candidates;
+    size_t candidate_capacity;
+    size_t candidate_count;
+
+    uint16_t phrase_count;
+    char phrases[DICTIONARY_CODEC_PHRASES_MAX][DICTIONARY_CODEC_PHRASE_MAX];
+    uint8_t phrase_lengths[DICTIONARY_CODEC_PHRASES_MAX];
+
+    EncoderTrieNode* trie;
+    size_t trie_count;
+    size_t trie_capacity;
+
+    uint64_t frequencies[ENCODER_SYMBOLS_MAX];
+    uint8_t lengths[ENCODER_SYMBOLS_MAX];
+    uint16_t codes[ENCODER_SYMBOLS_MAX];
+};
+
+DictionaryEncoder* dictionary_encoder_alloc(void) {
+    DictionaryEncoder* encoder = calloc(1, sizeof(DictionaryEncoder));
+    encoder->candidate_capacity = 1 << 16;
+    encoder->candidates = calloc(encoder->candidate_capacity, sizeof(EncoderCandidate));
+    return encoder;
+}
+
+void dictionary_encoder_free(DictionaryEncoder* encoder) {
+    free(encoder->candidates);
+    free(encoder->trie);
+    free(encoder);
+}
+
+static uint32_t encoder_hash(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Add count occurrences of a candidate to the hash table
+static void encoder_add_candidate(DictionaryEncoder* encoder, const char* text, size_t length, uint32_t count);
+
+static void encoder_grow_candidates(DictionaryEncoder* encoder) {
+    EncoderCandidate* old = encoder->candidates;
+    size_t old_capacity = encoder->candidate_capacity;
+
+    encoder->candidate_capacity *= 2;
+    encoder->candidates = calloc(encoder->candidate_capacity, sizeof(EncoderCandidate));
+    encoder->candidate_count = 0;
+    for(size_t i = 0; i < old_capacity; i++) {
+        if(old[i].length > 0) {
+            encoder_add_candidate(encoder, old[i].text, old[i].length, old[i].count);
+        }
+    }
+    free(old);
+}
+
+static void encoder_add_candidate(DictionaryEncoder* encoder, const char* text, size_t length, uint32_t count) {
+    if(length < 2 || length > DICTIONARY_CODEC_PHRASE_MAX) return;
+    if(encoder->candidate_count * 2 >= encoder->candidate_capacity) {
+        encoder_grow_candidates(encoder);
+    }
+
+    size_t mask = encoder->candidate_capacity - 1;
+    for(size_t slot = encoder_hash(text, length) & mask;; slot = (slot + 1) & mask) {
+        EncoderCandidate* candidate = &encoder->candidates[slot];
+        if(candidate->length == 0) {
+            candidate->length = length;
+            memcpy(candidate->text, text, length);
+            candidate->count = count;
+            encoder->candidate_count++;
+            return;
+        }
+        if(candidate->length == length && memcmp(candidate->text, text, length) == 0) {
+            candidate->count += count;
+            return;
+        }
+    }
+}
+
+// Letters, digits and any UTF-8 sequence byte
+static bool encoder_is_word_byte(uint8_t byte) {
+    return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9') ||
+           byte >= 0x80;
+}
+
+// Collect phrase candidates from a string
+void dictionary_encoder_train(DictionaryEncoder* encoder, const char* text) {
+    size_t length = strlen(text);
+    size_t i = 0;
+    while(i < length) {
+        if(!encoder_is_word_byte(text[i])) {
+            // Punctuation followed by a space, like ", " and ". "
+            if(i + 1 < length && text[i] != ' ' && text[i + 1] == ' ') {
+                encoder_add_candidate(encoder, text + i, 2, 1);
+            }
+            i++;
+            continue;
+        }
+
+        size_t end = i;
+        while(end < length && encoder_is_word_byte(text[end])) {
+            end++;
+        }
+
+        // The word alone, with the separator after it and with the space before it
+        encoder_add_candidate(encoder, text + i, end - i, 1);
+        if(end < length) {
+            encoder_add_candidate(encoder, text + i, end - i + 1, 1);
+        }
+        if(i > 0 && text[i - 1] == ' ') {
+            encoder_add_candidate(encoder, text + i - 1, end - i + 1, 1);
+        }
+        i = end;
+    }
+}
+
+static int64_t encoder_candidate_score(const EncoderCandidate* candidate) {
+    // Bytes saved by coding the phrase as one symbol, minus the table entry
+    return (int64_t)candidate->count * (candidate->length - 1) - candidate->length - 2;
+}
+
+static int encoder_compare_candidates(const void* a, const void* b) {
+    int64_t score_a = encoder_candidate_score(a);
+    int64_t score_b = encoder_candidate_score(b);
+    if(score_a != score_b) return score_a > score_b ? -1 : 1;
+    const EncoderCandidate* ca = a;
+    const EncoderCandidate* cb = b;
+    if(ca->length != cb->length) return ca->length - cb->length;
+    return memcmp(ca->text, cb->text, ca->length);
+}
+
+static int32_t encoder_trie_node(DictionaryEncoder* encoder, uint8_t byte) {
+    if(encoder->trie_count == encoder->trie_capacity) {
+        encoder->trie_capacity = encoder->trie_capacity ? encoder->trie_capacity * 2 : 256;
+        encoder->trie = realloc(encoder->trie, encoder->trie_capacity * sizeof(EncoderTrieNode));
+    }
+    EncoderTrieNode* node = &encoder->trie[encoder->trie_count];
+    node->child = -1;
+    node->sibling = -1;
+    node->phrase = -1;
+    node->byte = byte;
+    return encoder->trie_count++;
+}
+
+static void encoder_trie_insert(DictionaryEncoder* encoder, const char* text, size_t length, int16_t phrase) {
+    int32_t node = 0;
+    for(size_t i = 0; i < length; i++) {
+        uint8_t byte = text[i];
+        int32_t child = encoder->trie[node].child;
+        while(child >= 0 && encoder->trie[child].byte != byte) {
+            child = encoder->trie[child].sibling;
+        }
+        if(child < 0) {
+            child = encoder_trie_node(encoder, byte);
+            encoder->trie[child].sibling = encoder->trie[node].child;
+            encoder->trie[node].child = child;
+        }
+        node = child;
+    }
+    encoder->trie[node].phrase = phrase;
+}
+
+// Pick the phrases that save the most space
+void dictionary_encoder_build_phrases(DictionaryEncoder* encoder, uint16_t max_phrases) {
+    if(max_phrases > DICTIONARY_CODEC_PHRASES_MAX) {
+        max_phrases = DICTIONARY_CODEC_PHRASES_MAX;
+    }
+
+    // Compact the hash table into a ranked list
+    size_t count = 0;
+    for(size_t i = 0; i < encoder->candidate_capacity; i++) {
+        if(encoder->candidates[i].length > 0) {
+            encoder->candidates[count++] = encoder->candidates[i];
+        }
+    }
+    qsort(encoder->candidates, count, sizeof(EncoderCandidate), encoder_compare_candidates);
+
+    encoder->trie_count = 0;
+    encoder_trie_node(encoder, 0);
+    encoder->phrase_count = 0;
+    for(size_t i = 0; i < count && encoder->phrase_count < max_phrases; i++) {
+        if(encoder_candidate_score(&encoder->candidates[i]) <= 0) break;
+
+        uint16_t phrase = encoder->phrase_count++;
+        memcpy(encoder->phrases[phrase], encoder->candidates[i].text, encoder->candidates[i].length);
+        encoder->phrase_lengths[phrase] = encoder->candidates[i].length;
+        encoder_trie_insert(encoder, encoder->candidates[i].text, encoder->candidates[i].length, phrase);
+    }
+
+    free(encoder->candidates);
+    encoder->candidates = NULL;
+    encoder->candidate_capacity = 0;
+    encoder->candidate_count = 0;
+}
+
+// Take the longest phrase at the position, or a single byte
+static uint16_t encoder_next_symbol(DictionaryEncoder* encoder, const uint8_t* data, size_t size, size_t* position) {
+    int32_t node = 0;
+    int16_t best = -1;
+    size_t best_length = 1;
+    for(size_t i = *position; i < size && data[i] != '\0'; i++) {
+        int32_t child = encoder->trie[node].child;
+        while(child >= 0 && encoder->trie[child].byte != data[i]) {
+            child = encoder->trie[child].sibling;
+        }
+        if(child < 0) break;
+        node = child;
+        if(encoder->trie[node].phrase >= 0) {
+            best = encoder->trie[node].phrase;
+            best_length = i - *position + 1;
+        }
+    }
+
+    uint16_t symbol = best >= 0 ? DICTIONARY_CODEC_LITERALS + best : data[*position];
+    *position += best_length;
+    return symbol;
+}
+
+// Collect symbol frequencies from a block
+void dictionary_encoder_count(DictionaryEncoder* encoder, const uint8_t* data, size_t size) {
+    size_t position = 0;
+    while(position < size) {
+        encoder->frequencies[encoder_next_symbol(encoder, data, size, &position)]++;
+    }
+}
+
+// Huffman code lengths for the given frequencies, returns the longest code
+static uint8_t encoder_code_lengths(const uint64_t* frequencies, uint16_t symbol_count, uint8_t* lengths) {
+    uint64_t weight[2 * ENCODER_SYMBOLS_MAX];
+    int32_t parent[2 * ENCODER_SYMBOLS_MAX];
+    bool merged[2 * ENCODER_SYMBOLS_MAX];
+    uint16_t leaves = 0;
+    int32_t leaf_symbol[ENCODER_SYMBOLS_MAX];
+
+    for(uint16_t i = 0; i < symbol_count; i++) {
+        lengths[i] = 0;
+        if(frequencies[i] > 0) {
+            weight[leaves] = frequencies[i];
+            parent[leaves] = -1;
+            merged[leaves] = false;
+            leaf_symbol[leaves++] = i;
+        }
+    }
+    if(leaves == 0) return 0;
+    if(leaves == 1) {
+        lengths[leaf_symbol[0]] = 1;
+        return 1;
+    }
+
+    // Merge the two lightest nodes until one remains
+    uint32_t nodes = leaves;
+    for(uint32_t round = 0; round < (uint32_t)leaves - 1; round++) {
+        int32_t first = -1;
+        int32_t second = -1;
+        for(uint32_t i = 0; i < nodes; i++) {
+            if(merged[i]) continue;
+            if(first < 0 || weight[i] < weight[first]) {
+                second = first;
+                first = i;
+            } else if(second < 0 || weight[i] < weight[second]) {
+                second = i;
+            }
+        }
+        weight[nodes] = weight[first] + weight[second];
+        parent[nodes] = -1;
+        merged[nodes] = false;
+        parent[first] = nodes;
+        parent[second] = nodes;
+        merged[first] = true;
+        merged[second] = true;
+        nodes++;
+    }
+
+    uint8_t longest = 0;
+    for(uint16_t i = 0; i < leaves; i++) {
+        uint8_t depth = 0;
+        for(int32_t node = i; parent[node] >= 0; node = parent[node]) {
+            depth++;
+        }
+        lengths[leaf_symbol[i]] = depth;
+        if(depth > longest) longest = depth;
+    }
+    return longest;
+}
+
+// Build the Huffman code from the collected frequencies
+void dictionary_encoder_build_code(DictionaryEncoder* encoder) {
+    uint16_t symbol_count = DICTIONARY_CODEC_LITERALS + encoder->phrase_count;
+    uint64_t frequencies[ENCODER_SYMBOLS_MAX];
+    memcpy(frequencies, encoder->frequencies, sizeof(frequencies));
+
+    // Flatten the distribution until the longest code fits the decoder
+    while(encoder_code_lengths(frequencies, symbol_count, encoder->lengths) > DICTIONARY_CODEC_CODE_MAX) {
+        for(uint16_t i = 0; i < symbol_count; i++) {
+            if(frequencies[i] > 0) {
+                frequencies[i] = (frequencies[i] >> 1) | 1;
+            }
+        }
+    }
+
+    // Canonical codes, in the same order dictionary_codec.c rebuilds them
+    uint16_t code = 0;
+    for(uint8_t length = 1; length <= DICTIONARY_CODEC_CODE_MAX; length++) {
+        for(uint16_t i = 0; i < symbol_count; i++) {
+            if(encoder->lengths[i] == length) {
+                encoder->codes[i] = code++;
+            }
+        }
+        code <<= 1;
+    }
+}
+
+// Worst-case compressed size of a block of the given size
+size_t dictionary_encoder_bound(size_t size) {
+    return (size * DICTIONARY_CODEC_CODE_MAX + 7) / 8;
+}
+
+// Compress a block, returns the number of bytes written to output
+size_t dictionary_encoder_encode(
+    DictionaryEncoder* encoder,
+    const uint8_t* data,
+    size_t size,
+    uint8_t* output) {
+    uint32_t bits = 0;
+    uint8_t bit_count = 0;
+    size_t written = 0;
+    size_t position = 0;
+
+    while(position < size) {
+        uint16_t symbol = encoder_next_symbol(encoder, data, size, &position);
+        bits = (bits << encoder->lengths[symbol]) | encoder->codes[symbol];
+        bit_count += encoder->lengths[symbol];
+        while(bit_count >= 8) {
+            output[written++] = bits >> (bit_count - 8);
+            bit_count -= 8;
+        }
+    }
+    if(bit_count > 0) {
+        output[written++] = bits << (8 - bit_count);
+    }
+    return written;
+}
+
+// Size of the codec section
+size_t dictionary_encoder_codec_size(DictionaryEncoder* encoder) {
+    size_t size = sizeof(DictionaryFileCodecHeader) + DICTIONARY_CODEC_LITERALS + encoder->phrase_count;
+    size += (encoder->phrase_count + 1) * sizeof(uint16_t);
+    for(uint16_t i = 0; i < encoder->phrase_count; i++) {
+        size += encoder->phrase_lengths[i];
+    }
+    return size;
+}
+
+void dictionary_encoder_write_codec(
+    DictionaryEncoder* encoder,
+    uint16_t max_packed_size,
+    uint8_t* output) {
+    DictionaryFileCodecHeader header = {
+        .symbol_count = DICTIONARY_CODEC_LITERALS + encoder->phrase_count,
+        .max_packed_size = max_packed_size,
+    };
+    memcpy(output, &header, sizeof(header));
+    output += sizeof(header);
+
+    memcpy(output, encoder->lengths, header.symbol_count);
+    output += header.symbol_count;
+
+    uint16_t offset = 0;
+    for(uint16_t i = 0; i <= encoder->phrase_count; i++) {
+        memcpy(output, &offset, sizeof(offset));
+        output += sizeof(offset);
+        if(i < encoder->phrase_count) {
+            offset += encoder->phrase_lengths[i];
+        }
+    }
+    for(uint16_t i = 0; i < encoder->phrase_count; i++) {
+        memcpy(output, encoder->phrases[i], encoder->phrase_lengths[i]);
+        output += encoder->phrase_lengths[i];
+    }
+}
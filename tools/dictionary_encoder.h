@@ -0,0 +1,45 @@
+#pragma once
+
+// Host-side encoder for the compressed text blocks in dictionary_format.h
+//
+// Usage: feed every string to dictionary_encoder_train(), call
+// dictionary_encoder_build_phrases(), feed every block to
+// dictionary_encoder_count(), call dictionary_encoder_build_code(), then
+// encode the blocks. The decoder lives in dictionary_codec.c.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct DictionaryEncoder DictionaryEncoder;
+
+DictionaryEncoder* dictionary_encoder_alloc(void);
+void dictionary_encoder_free(DictionaryEncoder* encoder);
+
+// Collect phrase candidates from a string
+void dictionary_encoder_train(DictionaryEncoder* encoder, const char* text);
+
+// Pick the phrases that save the most space
+void dictionary_encoder_build_phrases(DictionaryEncoder* encoder, uint16_t max_phrases);
+
+// Collect symbol frequencies from a block
+void dictionary_encoder_count(DictionaryEncoder* encoder, const uint8_t* data, size_t size);
+
+// Build the Huffman code from the collected frequencies
+void dictionary_encoder_build_code(DictionaryEncoder* encoder);
+
+// Worst-case compressed size of a block of the given size
+size_t dictionary_encoder_bound(size_t size);
+
+// Compress a block, returns the number of bytes written to output
+size_t dictionary_encoder_encode(
+    DictionaryEncoder* encoder,
+    const uint8_t* data,
+    size_t size,
+    uint8_t* output);
+
+// Size of the codec section, max_packed_size is the largest encoded block
+size_t dictionary_encoder_codec_size(DictionaryEncoder* encoder);
+void dictionary_encoder_write_codec(
+    DictionaryEncoder* encoder,
+    uint16_t max_packed_size,
+    uint8_t* output);
@@ -0,0 +1,92 @@
+// Compile data/glyphs.tsv into the glyph width tables of dictionary_glyphs.h
+#include "dictionary_glyphs.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// Width of characters outside the tables, kept wide so text never overflows
+#define GLYPHS_OTHER_PRIMARY 8
+#define GLYPHS_OTHER_SECONDARY 6
+
+static const char* glyphs_font_names[DictionaryGlyphsFontCount] = {"FontPrimary", "FontSecondary"};
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s <glyphs.tsv> <output.c>\n", argv[0]);
+        return 2;
+    }
+
+    FILE* input = fopen(argv[1], "r");
+    if(input == NULL) {
+        fprintf(stderr, "%s: can't open\n", argv[1]);
+        return 1;
+    }
+
+    // Every slot must be given once, except the one for other characters
+    uint8_t widths[DictionaryGlyphsFontCount][DICTIONARY_GLYPHS_COUNT];
+    memset(widths, 0, sizeof(widths));
+    widths[DictionaryGlyphsFontPrimary][DICTIONARY_GLYPHS_COUNT - 1] = GLYPHS_OTHER_PRIMARY;
+    widths[DictionaryGlyphsFontSecondary][DICTIONARY_GLYPHS_COUNT - 1] = GLYPHS_OTHER_SECONDARY;
+
+    char line[256];
+    unsigned line_number = 0;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), input) != NULL) {
+        line_number++;
+        if(line[0] == '#' || line[0] == '\n') continue;
+
+        unsigned code;
+        unsigned primary;
+        unsigned secondary;
+        if(sscanf(line, "%x %u %u", &code, &primary, &secondary) != 3) {
+            fprintf(stderr, "%s:%u: expected code point and two widths\n", argv[1], line_number);
+            ok = false;
+            break;
+        }
+        unsigned slot = dictionary_glyphs_get_slot(code);
+        if(slot == DICTIONARY_GLYPHS_COUNT - 1 || primary == 0 || primary > 255 || secondary == 0 ||
+           secondary > 255) {
+            fprintf(stderr, "%s:%u: U+%04X outside the tables or width out of range\n", argv[1], line_number, code);
+            ok = false;
+        } else if(widths[DictionaryGlyphsFontPrimary][slot] != 0) {
+            fprintf(stderr, "%s:%u: U+%04X given twice\n", argv[1], line_number, code);
+            ok = false;
+        } else {
+            widths[DictionaryGlyphsFontPrimary][slot] = primary;
+            widths[DictionaryGlyphsFontSecondary][slot] = secondary;
+        }
+    }
+    fclose(input);
+    for(unsigned slot = 0; ok && slot < DICTIONARY_GLYPHS_COUNT; slot++) {
+        if(widths[DictionaryGlyphsFontPrimary][slot] == 0) {
+            fprintf(stderr, "%s: no width for table slot %u\n", argv[1], slot);
+            ok = false;
+        }
+    }
+    if(!ok) return 1;
+
+    FILE* output = fopen(argv[2], "w");
+    if(output == NULL) {
+        fprintf(stderr, "%s: can't create\n", argv[2]);
+        return 1;
+    }
+    fprintf(output, "// Generated from data/glyphs.tsv by tools/dictionary_glyphs, do not edit\n");
+    fprintf(output, "#include \"dictionary_glyphs.h\"\n\n");
+    fprintf(output, "const uint8_t dictionary_glyphs_widths[DictionaryGlyphsFontCount][DICTIONARY_GLYPHS_COUNT] = {\n");
+    for(unsigned font = 0; font < DictionaryGlyphsFontCount; font++) {
+        fprintf(output, "    // %s\n    {", glyphs_font_names[font]);
+        for(unsigned slot = 0; slot < DICTIONARY_GLYPHS_COUNT; slot++) {
+            fprintf(output, "%s%u,", slot % 16 == 0 ? "\n        " : " ", widths[font][slot]);
+        }
+        fprintf(output, "\n    },\n");
+    }
+    fprintf(output, "};\n");
+    if(fclose(output) != 0) {
+        fprintf(stderr, "%s: can't write\n", argv[2]);
+        return 1;
+    }
+
+    printf("%s: %u glyphs in %u fonts\n", argv[2], DICTIONARY_GLYPHS_COUNT - 1, DictionaryGlyphsFontCount);
+    return 0;
+}
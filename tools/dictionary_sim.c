@@ -0,0 +1,346 @@
+// Headless run of the dictionary app on the host
+//
+// Runs dictionary_app() on the host implementations of the mock headers and
+// replays a script of key presses through the input callback, as the input
+// service would. After each input event the simulator waits until the event
+// loop is idle again, then draws the frame the app asked for on a 128x64
+// frame buffer, and reports how long handling the events and drawing the
+// frames took. Run with `make sim`.
+//
+// A script has one command per line, and # starts a comment:
+//
+//   down [count]          press and release a key: up, down, left, right,
+//                         ok or back
+//   long right [count]    hold a key past the long press delay
+//   hold down <repeats>   hold a key until it repeats that many times
+//   burst down <taps>     tap a key that many times faster than the app
+//                         reads its queue, and fail the run unless it took
+//                         every tap in and redrew once
+//   wait <ms>             let time pass, drawing the frames the search
+//                         worker's results ask for
+//   dump                  print the last frame drawn
+
+#include "dictionary_app.h"
+#include "host.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Back presses sent after the script to close the app
+#define SIM_CLOSE_PRESSES 16
+
+typedef struct {
+    uint32_t* values; // Durations in microseconds
+    size_t count;
+    size_t capacity;
+} SimTimes;
+
+typedef struct {
+    bool verbose;
+    uint32_t line;
+    SimTimes events;
+    SimTimes frames;
+    bool failed; // A burst was not handled as one batch
+} Sim;
+
+// Script names of the keys, by InputKey value
+static const char* const sim_keys[] = {NULL, "up", "down", "right", "left", "ok", "back"};
+
+// Set by the app thread when dictionary_app() returns
+static bool app_done = false;
+static int32_t app_result = 0;
+
+static bool sim_app_done(void) {
+    return __atomic_load_n(&app_done, __ATOMIC_ACQUIRE);
+}
+
+static double sim_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static void sim_times_add(SimTimes* times, double us) {
+    if(times->count == times->capacity) {
+        times->capacity = times->capacity ? times->capacity * 2 : 256;
+        times->values = realloc(times->values, times->capacity * sizeof(uint32_t));
+    }
+    times->values[times->count++] = (uint32_t)(us + 0.5);
+}
+
+static int sim_compare(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Get a percentile of sorted times
+static uint32_t sim_times_percentile(const SimTimes* times, uint32_t percent) {
+    if(times->count == 0) return 0;
+    return times->values[(times->count - 1) * percent / 100];
+}
+
+// Print a summary line and return the 95th percentile
+static uint32_t sim_times_report(const char* name, SimTimes* times) {
+    qsort(times->values, times->count, sizeof(uint32_t), sim_compare);
+    uint64_t total = 0;
+    for(size_t i = 0; i < times->count; i++) {
+        total += times->values[i];
+    }
+    printf(
+        "%-7s %6zu  mean %7.0f us  p50 %7u us  p95 %7u us  max %7u us\n",
+        name,
+        times->count,
+        times->count ? (double)total / times->count : 0.0,
+        sim_times_percentile(times, 50),
+        sim_times_percentile(times, 95),
+        times->count ? times->values[times->count - 1] : 0);
+    return sim_times_percentile(times, 95);
+}
+
+// Draw the frame on screen and time it
+static void sim_draw_frame(Sim* sim) {
+    double start = sim_now_us();
+    if(!gui_host_draw()) return;
+    double us = sim_now_us() - start;
+    sim_times_add(&sim->frames, us);
+    if(sim->verbose) {
+        printf("%5u  frame         %8.0f us\n", sim->line, us);
+    }
+}
+
+// Draw the frame the app asked for, if it asked
+static void sim_draw(Sim* sim) {
+    if(gui_host_take_update() > 0) {
+        sim_draw_frame(sim);
+    }
+}
+
+// Send one input event, wait for the event loop to handle it, then draw
+static void sim_send(Sim* sim, int key, int type) {
+    static const char* const types[] = {"?", "press", "release", "short", "long", "repeat"};
+    if(sim_app_done()) return;
+
+    InputEvent event = {.type = type, .key = key};
+    double start = sim_now_us();
+    if(!gui_host_send_input(&event)) return;
+    furi_host_wait_idle();
+    double us = sim_now_us() - start;
+    sim_times_add(&sim->events, us);
+    if(sim->verbose) {
+        printf("%5u  %-5s %-7s %8.0f us\n", sim->line, sim_keys[key], types[type], us);
+    }
+    sim_draw(sim);
+}
+
+// Tap a key several times while the app's queue is held, as presses come
+// in faster than the event loop wakes up, then let the loop handle them
+static void sim_burst(Sim* sim, int key, uint32_t taps) {
+    if(sim_app_done()) return;
+
+    furi_host_take_dropped();
+    double start = sim_now_us();
+    furi_host_hold_queues(true);
+    for(uint32_t i = 0; i < taps; i++) {
+        InputEvent press = {.type = InputTypePress, .key = key};
+        InputEvent tap = {.type = InputTypeShort, .key = key};
+        InputEvent release = {.type = InputTypeRelease, .key = key};
+        gui_host_send_input(&press);
+        gui_host_send_input(&tap);
+        gui_host_send_input(&release);
+    }
+    furi_host_hold_queues(false);
+    furi_host_wait_idle();
+    double us = sim_now_us() - start;
+    sim_times_add(&sim->events, us);
+    if(sim->verbose) {
+        printf("%5u  %-5s burst   %8.0f us\n", sim->line, sim_keys[key], us);
+    }
+
+    // Queued together, the taps make one batch and one frame
+    uint32_t dropped = furi_host_take_dropped();
+    uint32_t redraws = gui_host_take_update();
+    if(redraws > 0) {
+        sim_draw_frame(sim);
+    }
+    if(dropped > 0 || redraws != 1) {
+        fprintf(
+            stderr,
+            "line %u: %u taps lost %u events to a full queue and asked for %u redraws\n",
+            sim->line,
+            taps,
+            dropped,
+            redraws);
+        sim->failed = true;
+    }
+}
+
+// Let time pass while the app runs on its own
+static void sim_wait(Sim* sim, uint32_t ms) {
+    double end = sim_now_us() + ms * 1000.0;
+    while(!sim_app_done() && sim_now_us() < end) {
+        sim_draw(sim);
+        usleep(1000);
+    }
+    sim_draw(sim);
+}
+
+static int sim_parse_key(const char* name) {
+    for(int key = InputKeyUp; key <= InputKeyBack; key++) {
+        if(strcmp(name, sim_keys[key]) == 0) return key;
+    }
+    return 0;
+}
+
+// Run one script line. Returns false on a syntax error.
+static bool sim_run_line(Sim* sim, char* line) {
+    char* comment = strchr(line, '#');
+    if(comment != NULL) {
+        *comment = '\0';
+    }
+    char* words[3] = {NULL, NULL, NULL};
+    int count = 0;
+    for(char* word = strtok(line, " \t\r\n"); word != NULL; word = strtok(NULL, " \t\r\n")) {
+        if(count == 3) return false;
+        words[count++] = word;
+    }
+    if(count == 0) return true;
+
+    if(strcmp(words[0], "dump") == 0) {
+        if(count != 1) return false;
+        gui_host_dump(stdout);
+        return true;
+    }
+    if(strcmp(words[0], "wait") == 0) {
+        if(count != 2) return false;
+        sim_wait(sim, strtoul(words[1], NULL, 10));
+        return true;
+    }
+
+    if(strcmp(words[0], "burst") == 0) {
+        int key = count == 3 ? sim_parse_key(words[1]) : 0;
+        if(key == 0) return false;
+        sim_burst(sim, key, strtoul(words[2], NULL, 10));
+        return true;
+    }
+
+    bool hold = strcmp(words[0], "hold") == 0;
+    bool long_press = strcmp(words[0], "long") == 0;
+    int first = hold || long_press ? 1 : 0;
+    if(first >= count) return false;
+    int key = sim_parse_key(words[first]);
+    if(key == 0 || count > first + 2 || (hold && count != 3)) return false;
+    uint32_t repeat = count == first + 2 ? strtoul(words[first + 1], NULL, 10) : 1;
+
+    if(hold) {
+        sim_send(sim, key, InputTypePress);
+        sim_send(sim, key, InputTypeLong);
+        for(uint32_t i = 0; i < repeat; i++) {
+            sim_send(sim, key, InputTypeRepeat);
+        }
+        sim_send(sim, key, InputTypeRelease);
+        return true;
+    }
+    for(uint32_t i = 0; i < repeat; i++) {
+        sim_send(sim, key, InputTypePress);
+        sim_send(sim, key, long_press ? InputTypeLong : InputTypeShort);
+        sim_send(sim, key, InputTypeRelease);
+    }
+    return true;
+}
+
+static void* sim_app_thread(void* context) {
+    (void)context;
+    app_result = dictionary_app(NULL);
+    __atomic_store_n(&app_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    Sim sim = {0};
+    uint32_t limit = 0;
+    int opt;
+    while((opt = getopt(argc, argv, "vm:")) != -1) {
+        if(opt == 'v') {
+            sim.verbose = true;
+        } else if(opt == 'm') {
+            limit = strtoul(optarg, NULL, 10);
+        } else {
+            optind = argc + 1;
+            break;
+        }
+    }
+    if(argc - optind < 2 || argc - optind > 3) {
+        fprintf(
+            stderr,
+            "usage: %s [-v] [-m max p95 us] <script> <data dir> [assets dir]\n"
+            "  the app reads dictionary.dict from the data dir, else from the assets dir,\n"
+            "  and keeps its favorites and history in the data dir\n",
+            argv[0]);
+        return 2;
+    }
+
+    FILE* script = fopen(argv[optind], "r");
+    if(script == NULL) {
+        fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+        return 2;
+    }
+    mkdir(argv[optind + 1], 0755);
+    storage_host_map("/data/", argv[optind + 1]);
+    storage_host_map("/assets/", argc - optind == 3 ? argv[optind + 2] : argv[optind + 1]);
+
+    pthread_t app;
+    pthread_create(&app, NULL, sim_app_thread, NULL);
+
+    // Start once the app is waiting for input, with its first frame drawn. A
+    // repeat of OK changes nothing in the main list, but is queued, so the loop
+    // can be waited for as after any key.
+    InputEvent probe = {.type = InputTypeRepeat, .key = InputKeyOk};
+    while(!sim_app_done() && !gui_host_send_input(&probe)) {
+        usleep(1000);
+    }
+    furi_host_wait_idle();
+    gui_host_take_update();
+    gui_host_draw();
+
+    bool ok = true;
+    char line[256];
+    while(ok && !sim_app_done() && fgets(line, sizeof(line), script) != NULL) {
+        sim.line++;
+        if(!sim_run_line(&sim, line)) {
+            fprintf(stderr, "%s:%u: cannot parse the line\n", argv[optind], sim.line);
+            ok = false;
+        }
+    }
+    fclose(script);
+
+    for(int i = 0; i < SIM_CLOSE_PRESSES && !sim_app_done(); i++) {
+        sim_send(&sim, InputKeyBack, InputTypePress);
+        sim_send(&sim, InputKeyBack, InputTypeShort);
+        sim_send(&sim, InputKeyBack, InputTypeRelease);
+        sim_wait(&sim, 100);
+    }
+    if(!sim_app_done()) {
+        fprintf(stderr, "the app did not exit\n");
+        return 1;
+    }
+    pthread_join(app, NULL);
+
+    uint32_t event_p95 = sim_times_report("events", &sim.events);
+    uint32_t frame_p95 = sim_times_report("frames", &sim.frames);
+    free(sim.events.values);
+    free(sim.frames.values);
+
+    if(!ok || sim.failed || app_result != 0) return 1;
+    if(limit > 0 && (event_p95 > limit || frame_p95 > limit)) {
+        fprintf(stderr, "95th percentile over %u us\n", limit);
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+// Host implementation of the furi.h and furi_hal.h mocks, used by the tools in
+// this directory. Message queues, mutexes and threads run on POSIX threads.
+#include "furi.h"
+#include "furi_hal.h"
+#include "host.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Queues that can be alive at once
+#define FURI_HOST_QUEUES 8
+
+// Cycles per microsecond of the device CPU, the rate the cycle counter runs at
+#define FURI_HOST_CYCLES_PER_US 64
+
+struct FuriMessageQueue {
+    uint32_t size;
+    uint32_t item_size;
+    uint32_t head;
+    uint32_t count;
+    uint32_t readers; // Threads blocked until a message arrives
+    uint8_t* items;
+};
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+struct FuriThread {
+    pthread_t thread;
+    FuriThreadCallback callback;
+    void* context;
+    bool started;
+};
+
+// All queues share one lock, so a queue can be watched while it is freed
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_changed = PTHREAD_COND_INITIALIZER;
+static FuriMessageQueue* queues[FURI_HOST_QUEUES];
+
+// Queue the calling thread last wrote to
+static __thread FuriMessageQueue* last_written = NULL;
+
+// Set while messages are held back from readers, see furi_host_hold_queues()
+static bool holding = false;
+
+// Messages refused by full queues, see furi_host_take_dropped()
+static uint32_t dropped = 0;
+
+void furi_assert(int condition) {
+    if(!condition) {
+        fprintf(stderr, "furi_assert failed\n");
+        abort();
+    }
+}
+
+void furi_check(int condition) {
+    if(!condition) {
+        fprintf(stderr, "furi_check failed\n");
+        abort();
+    }
+}
+
+void furi_log_print_format(int level, const char* tag, const char* format, ...) {
+    static const char levels[] = "?EWID";
+    if(level < 1 || level > 2) return;
+
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%c][%s] ", levels[level], tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+void* furi_record_open(const char* record_name) {
+    (void)record_name;
+    return NULL;
+}
+
+void furi_record_close(const char* record_name) {
+    (void)record_name;
+}
+
+// Check if a queue has not been freed, with the queue lock held
+static bool furi_host_queue_alive(const FuriMessageQueue* queue) {
+    for(int i = 0; i < FURI_HOST_QUEUES; i++) {
+        if(queues[i] == queue && queue != NULL) return true;
+    }
+    return false;
+}
+
+// Wait for the queue to change until a deadline, or for good without one
+static bool furi_host_queue_wait(const struct timespec* deadline) {
+    if(deadline == NULL) {
+        pthread_cond_wait(&queue_changed, &queue_lock);
+        return true;
+    }
+    return pthread_cond_timedwait(&queue_changed, &queue_lock, deadline) != ETIMEDOUT;
+}
+
+// Turn a timeout in milliseconds into a deadline, NULL to wait forever
+static const struct timespec* furi_host_deadline(uint32_t timeout, struct timespec* deadline) {
+    if(timeout == (uint32_t)FuriWaitForever) return NULL;
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (long)(timeout % 1000) * 1000000;
+    if(deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t size, uint32_t item_size) {
+    FuriMessageQueue* queue = calloc(1, sizeof(FuriMessageQueue));
+    queue->size = size;
+    queue->item_size = item_size;
+    queue->items = malloc((size_t)size * item_size);
+
+    pthread_mutex_lock(&queue_lock);
+    int i = 0;
+    while(i < FURI_HOST_QUEUES && queues[i] != NULL) {
+        i++;
+    }
+    furi_check(i < FURI_HOST_QUEUES);
+    queues[i] = queue;
+    pthread_mutex_unlock(&queue_lock);
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue_lock);
+    for(int i = 0; i < FURI_HOST_QUEUES; i++) {
+        if(queues[i] == queue) {
+            queues[i] = NULL;
+        }
+    }
+    pthread_cond_broadcast(&queue_changed);
+    pthread_mutex_unlock(&queue_lock);
+
+    free(queue->items);
+    free(queue);
+}
+
+int furi_message_queue_get(FuriMessageQueue* queue, void* message, uint32_t timeout) {
+    struct timespec deadline;
+    const struct timespec* until = timeout ? furi_host_deadline(timeout, &deadline) : NULL;
+
+    pthread_mutex_lock(&queue_lock);
+    bool waiting = timeout != 0;
+    while((queue->count == 0 || holding) && waiting) {
+        queue->readers++;
+        pthread_cond_broadcast(&queue_changed);
+        waiting = furi_host_queue_wait(until);
+        queue->readers--;
+    }
+
+    FuriStatus status = FuriStatusErrorTimeout;
+    if(queue->count > 0 && !holding) {
+        memcpy(message, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->size;
+        queue->count--;
+        pthread_cond_broadcast(&queue_changed);
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&queue_lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* message, uint32_t timeout) {
+    struct timespec deadline;
+    const struct timespec* until = timeout ? furi_host_deadline(timeout, &deadline) : NULL;
+
+    pthread_mutex_lock(&queue_lock);
+    bool waiting = timeout != 0;
+    while(queue->count == queue->size && waiting) {
+        waiting = furi_host_queue_wait(until);
+    }
+
+    FuriStatus status = FuriStatusErrorTimeout;
+    if(queue->count < queue->size) {
+        uint32_t tail = (queue->head + queue->count) % queue->size;
+        memcpy(queue->items + (size_t)tail * queue->item_size, message, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue_changed);
+        status = FuriStatusOk;
+    } else {
+        dropped++;
+    }
+    last_written = queue;
+    pthread_mutex_unlock(&queue_lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_reset(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue_lock);
+    queue->head = 0;
+    queue->count = 0;
+    pthread_cond_broadcast(&queue_changed);
+    pthread_mutex_unlock(&queue_lock);
+    return FuriStatusOk;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue_lock);
+    uint32_t count = queue->count;
+    pthread_mutex_unlock(&queue_lock);
+    return count;
+}
+
+void furi_host_hold_queues(bool hold) {
+    pthread_mutex_lock(&queue_lock);
+    holding = hold;
+    pthread_cond_broadcast(&queue_changed);
+    pthread_mutex_unlock(&queue_lock);
+}
+
+uint32_t furi_host_take_dropped(void) {
+    pthread_mutex_lock(&queue_lock);
+    uint32_t count = dropped;
+    dropped = 0;
+    pthread_mutex_unlock(&queue_lock);
+    return count;
+}
+
+void furi_host_wait_idle(void) {
+    pthread_mutex_lock(&queue_lock);
+    while(furi_host_queue_alive(last_written) && (last_written->count > 0 || last_written->readers == 0)) {
+        pthread_cond_wait(&queue_changed, &queue_lock);
+    }
+    pthread_mutex_unlock(&queue_lock);
+}
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    if(type == FuriMutexTypeRecursive) {
+        pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    }
+    pthread_mutex_init(&mutex->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    pthread_mutex_destroy(&mutex->mutex);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    if(timeout == 0) {
+        return pthread_mutex_trylock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusErrorTimeout;
+    }
+    return pthread_mutex_lock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    return pthread_mutex_unlock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+// Run a thread's callback on its POSIX thread
+static void* furi_host_thread_body(void* context) {
+    FuriThread* thread = context;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context) {
+    (void)name;
+    (void)stack_size;
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+// Priorities are left to the host scheduler
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority) {
+    (void)thread;
+    (void)priority;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    thread->started = pthread_create(&thread->thread, NULL, furi_host_thread_body, thread) == 0;
+    furi_check(thread->started);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(!thread->started) return false;
+    thread->started = false;
+    return pthread_join(thread->thread, NULL) == 0;
+}
+
+void furi_thread_yield(void) {
+    sched_yield();
+}
+
+// The cycle counter of the calling thread, set from the monotonic clock
+DWT_Type* furi_hal_host_get_dwt(void) {
+    static __thread DWT_Type dwt;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+    dwt.CYCCNT = (uint32_t)(ns * FURI_HOST_CYCLES_PER_US / 1000);
+    return &dwt;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return FURI_HOST_CYCLES_PER_US;
+}
@@ -0,0 +1,218 @@
+// Host implementation of the gui, input and notification mocks: one view
+// port drawn on a 128x64 frame buffer whenever the caller asks, the way the
+// GUI thread draws it on the device
+#include "gui/gui.h"
+#include "gui/elements.h"
+#include "notification/notification_messages.h"
+#include "dictionary_layout.h"
+#include "host.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Pixels of a glyph above the baseline, by font
+#define GUI_HOST_PRIMARY_HEIGHT 7
+#define GUI_HOST_SECONDARY_HEIGHT 6
+
+struct ViewPort {
+    void (*draw_callback)(Canvas*, void*);
+    void* draw_context;
+    void (*input_callback)(InputEvent*, void*);
+    void* input_context;
+};
+
+struct Canvas {
+    uint8_t pixels[GUI_HOST_HEIGHT][GUI_HOST_WIDTH];
+    uint8_t buffer[GUI_HOST_WIDTH * GUI_HOST_HEIGHT / 8]; // The same in the display's layout
+    int font;
+};
+
+// The view port on screen, guarded so it is not drawn while it is removed
+static pthread_mutex_t gui_lock = PTHREAD_MUTEX_INITIALIZER;
+static ViewPort* shown = NULL;
+static Canvas canvas;
+static int updates = 0;
+
+// Gets every frame drawn, as the display does
+static GuiCanvasCommitCallback commit_callback = NULL;
+static void* commit_context = NULL;
+
+const NotificationSequence sequence_display_backlight_on = {0};
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    (void)app;
+    (void)sequence;
+}
+
+ViewPort* view_port_alloc() {
+    return calloc(1, sizeof(ViewPort));
+}
+
+void view_port_free(ViewPort* view_port) {
+    free(view_port);
+}
+
+void view_port_draw_callback_set(ViewPort* view_port, void (*callback)(Canvas*, void*), void* context) {
+    view_port->draw_callback = callback;
+    view_port->draw_context = context;
+}
+
+void view_port_input_callback_set(ViewPort* view_port, void (*callback)(InputEvent*, void*), void* context) {
+    view_port->input_callback = callback;
+    view_port->input_context = context;
+}
+
+void view_port_update(ViewPort* view_port) {
+    (void)view_port;
+    __atomic_add_fetch(&updates, 1, __ATOMIC_SEQ_CST);
+}
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, int layer) {
+    (void)gui;
+    (void)layer;
+    pthread_mutex_lock(&gui_lock);
+    shown = view_port;
+    pthread_mutex_unlock(&gui_lock);
+}
+
+void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    (void)gui;
+    pthread_mutex_lock(&gui_lock);
+    if(shown == view_port) {
+        shown = NULL;
+    }
+    pthread_mutex_unlock(&gui_lock);
+}
+
+void gui_add_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context) {
+    (void)gui;
+    pthread_mutex_lock(&gui_lock);
+    commit_callback = callback;
+    commit_context = context;
+    pthread_mutex_unlock(&gui_lock);
+}
+
+void gui_remove_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context) {
+    (void)gui;
+    pthread_mutex_lock(&gui_lock);
+    if(commit_callback == callback && commit_context == context) {
+        commit_callback = NULL;
+    }
+    pthread_mutex_unlock(&gui_lock);
+}
+
+bool gui_host_send_input(InputEvent* event) {
+    pthread_mutex_lock(&gui_lock);
+    bool sent = shown != NULL && shown->input_callback != NULL;
+    if(sent) {
+        shown->input_callback(event, shown->input_context);
+    }
+    pthread_mutex_unlock(&gui_lock);
+    return sent;
+}
+
+uint32_t gui_host_take_update(void) {
+    return __atomic_exchange_n(&updates, 0, __ATOMIC_SEQ_CST);
+}
+
+bool gui_host_draw(void) {
+    pthread_mutex_lock(&gui_lock);
+    bool drawn = shown != NULL && shown->draw_callback != NULL;
+    if(drawn) {
+        canvas_clear(&canvas);
+        shown->draw_callback(&canvas, shown->draw_context);
+        if(commit_callback != NULL) {
+            commit_callback(canvas.buffer, sizeof(canvas.buffer), CanvasOrientationHorizontal, commit_context);
+        }
+    }
+    pthread_mutex_unlock(&gui_lock);
+    return drawn;
+}
+
+void gui_host_dump(FILE* stream) {
+    for(int y = 0; y < GUI_HOST_HEIGHT; y++) {
+        char line[GUI_HOST_WIDTH + 2];
+        for(int x = 0; x < GUI_HOST_WIDTH; x++) {
+            line[x] = canvas.pixels[y][x] ? '#' : '.';
+        }
+        line[GUI_HOST_WIDTH] = '\n';
+        line[GUI_HOST_WIDTH + 1] = '\0';
+        fputs(line, stream);
+    }
+}
+
+// Set a pixel, clipped to the screen
+static void gui_host_dot(Canvas* canvas, int x, int y) {
+    if(x >= 0 && x < GUI_HOST_WIDTH && y >= 0 && y < GUI_HOST_HEIGHT) {
+        canvas->pixels[y][x] = 1;
+        canvas->buffer[(y / 8) * GUI_HOST_WIDTH + x] |= 1 << (y % 8);
+    }
+}
+
+// Fill a rectangle, clipped to the screen
+static void gui_host_box(Canvas* canvas, int x, int y, int width, int height) {
+    for(int row = y; row < y + height; row++) {
+        for(int column = x; column < x + width; column++) {
+            gui_host_dot(canvas, column, row);
+        }
+    }
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->pixels, 0, sizeof(canvas->pixels));
+    memset(canvas->buffer, 0, sizeof(canvas->buffer));
+    canvas->font = FontSecondary;
+}
+
+void canvas_set_font(Canvas* canvas, int font) {
+    canvas->font = font;
+}
+
+// Glyphs are drawn as blocks of their advance width less the gap after them
+void canvas_draw_str(Canvas* canvas, int x, int y, const char* str) {
+    DictionaryGlyphsFont font =
+        canvas->font == FontPrimary ? DictionaryGlyphsFontPrimary : DictionaryGlyphsFontSecondary;
+    int height = canvas->font == FontPrimary ? GUI_HOST_PRIMARY_HEIGHT : GUI_HOST_SECONDARY_HEIGHT;
+    while(*str != '\0') {
+        char glyph[5];
+        size_t length = 1;
+        while(length < sizeof(glyph) - 1 && ((uint8_t)str[length] & 0xc0) == 0x80) {
+            length++;
+        }
+        memcpy(glyph, str, length);
+        glyph[length] = '\0';
+        str += length;
+
+        int width = dictionary_layout_get_width(font, glyph);
+        if(glyph[0] != ' ') {
+            gui_host_box(canvas, x, y - height, width - 1, height);
+        }
+        x += width;
+    }
+}
+
+void canvas_draw_dot(Canvas* canvas, int x, int y) {
+    gui_host_dot(canvas, x, y);
+}
+
+void canvas_draw_frame(Canvas* canvas, int x, int y, int width, int height) {
+    gui_host_box(canvas, x, y, width, 1);
+    gui_host_box(canvas, x, y + height - 1, width, 1);
+    gui_host_box(canvas, x, y, 1, height);
+    gui_host_box(canvas, x + width - 1, y, 1, height);
+}
+
+// A dotted track with a solid thumb, as the firmware draws it
+void elements_scrollbar_pos(Canvas* canvas, int32_t x, int32_t y, size_t height, size_t pos, size_t total) {
+    if(total == 0 || height < 3) return;
+    for(size_t row = 0; row < height; row += 2) {
+        gui_host_dot(canvas, x - 2, y + (int)row);
+    }
+    size_t thumb = height / total;
+    if(thumb < 2) {
+        thumb = 2;
+    }
+    size_t top = total > 1 ? pos * (height - thumb) / (total - 1) : 0;
+    gui_host_box(canvas, x - 3, y + (int)top, 3, (int)thumb);
+}
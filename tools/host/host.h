@@ -0,0 +1,50 @@
+#pragma once
+
+// Extra hooks of the host implementations of the mock headers
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "input/input.h"
+
+// Map a device path prefix such as "/data/" to a host directory
+void storage_host_map(const char* prefix, const char* directory);
+
+typedef struct {
+    uint64_t read_calls;
+    uint64_t read_bytes;
+} StorageHostStats;
+
+// Storage traffic since the last reset
+void storage_host_get_stats(StorageHostStats* stats);
+void storage_host_reset_stats(void);
+
+// Hold back the messages of every queue from their readers, as if they were
+// empty, so that several can be queued before a reader sees the first
+void furi_host_hold_queues(bool hold);
+
+// Take the number of messages refused by full queues since the last call
+uint32_t furi_host_take_dropped(void);
+
+// Wait until a thread blocks reading the queue that the calling thread last
+// wrote to, or until that queue is freed. For the event queue of an app this
+// means its event loop has handled everything sent to it.
+void furi_host_wait_idle(void);
+
+// Size of the host canvas, that of the screen
+#define GUI_HOST_WIDTH 128
+#define GUI_HOST_HEIGHT 64
+
+// Send an input event to the view port on screen, as the input service does.
+// Returns false if there is none.
+bool gui_host_send_input(InputEvent* event);
+
+// Take the redraw requests made since the last call. Returns their number.
+uint32_t gui_host_take_update(void);
+
+// Draw the view port on screen on the host canvas. Returns false if there is none.
+bool gui_host_draw(void);
+
+// Print the host canvas, a character per pixel
+void gui_host_dump(FILE* stream);
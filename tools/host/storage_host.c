@@ -0,0 +1,158 @@
+// Host implementation of the storage.h mock on top of stdio
+#include "storage/storage.h"
+#include "host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STORAGE_HOST_MAPPINGS 4
+
+struct File {
+    FILE* stream;
+};
+
+typedef struct {
+    char prefix[16];
+    char directory[256];
+} StorageHostMapping;
+
+static StorageHostMapping mappings[STORAGE_HOST_MAPPINGS];
+static StorageHostStats stats;
+
+void storage_host_map(const char* prefix, const char* directory) {
+    for(int i = 0; i < STORAGE_HOST_MAPPINGS; i++) {
+        if(mappings[i].prefix[0] == '\0' || strcmp(mappings[i].prefix, prefix) == 0) {
+            snprintf(mappings[i].prefix, sizeof(mappings[i].prefix), "%s", prefix);
+            snprintf(mappings[i].directory, sizeof(mappings[i].directory), "%s", directory);
+            return;
+        }
+    }
+}
+
+void storage_host_get_stats(StorageHostStats* out) {
+    *out = stats;
+}
+
+void storage_host_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Translate a device path, returns false for unmapped paths
+static bool storage_host_path(const char* path, char* out, size_t size) {
+    for(int i = 0; i < STORAGE_HOST_MAPPINGS; i++) {
+        size_t length = strlen(mappings[i].prefix);
+        if(length > 0 && strncmp(path, mappings[i].prefix, length) == 0) {
+            snprintf(out, size, "%s/%s", mappings[i].directory, path + length);
+            return true;
+        }
+    }
+    return false;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    (void)storage;
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    if(file->stream != NULL) {
+        fclose(file->stream);
+    }
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host_path[512];
+    if(!storage_host_path(path, host_path, sizeof(host_path))) {
+        return false;
+    }
+
+    const char* mode = "rb";
+    if(access_mode & FSAM_WRITE) {
+        if(open_mode == FSOM_CREATE_ALWAYS) {
+            mode = (access_mode & FSAM_READ) ? "w+b" : "wb";
+        } else if(open_mode == FSOM_OPEN_APPEND) {
+            mode = (access_mode & FSAM_READ) ? "a+b" : "ab";
+        } else {
+            mode = "r+b";
+        }
+    }
+
+    file->stream = fopen(host_path, mode);
+    if(file->stream == NULL && (access_mode & FSAM_WRITE) && open_mode == FSOM_OPEN_ALWAYS) {
+        file->stream = fopen(host_path, "w+b");
+    }
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(file->stream == NULL) return false;
+    bool ok = fclose(file->stream) == 0;
+    file->stream = NULL;
+    return ok;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    size_t read = fread(buff, 1, bytes_to_read, file->stream);
+    stats.read_calls++;
+    stats.read_bytes += read;
+    return read;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return fseek(file->stream, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_size(File* file) {
+    long position = ftell(file->stream);
+    fseek(file->stream, 0, SEEK_END);
+    long size = ftell(file->stream);
+    fseek(file->stream, position, SEEK_SET);
+    return size < 0 ? 0 : (uint64_t)size;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    return fwrite(buff, 1, bytes_to_write, file->stream);
+}
+
+uint64_t storage_file_tell(File* file) {
+    long position = ftell(file->stream);
+    return position < 0 ? 0 : (uint64_t)position;
+}
+
+// Cut the file at the current position
+bool storage_file_truncate(File* file) {
+    return fflush(file->stream) == 0 && ftruncate(fileno(file->stream), ftell(file->stream)) == 0;
+}
+
+bool storage_file_sync(File* file) {
+    return fflush(file->stream) == 0 && fsync(fileno(file->stream)) == 0;
+}
+
+bool storage_common_exists(Storage* storage, const char* path) {
+    (void)storage;
+    char host_path[512];
+    return storage_host_path(path, host_path, sizeof(host_path)) && access(host_path, F_OK) == 0;
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    (void)storage;
+    char host_path[512];
+    if(!storage_host_path(path, host_path, sizeof(host_path))) return FSE_INVALID_NAME;
+    return remove(host_path) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+// Like the device, refuses to replace an existing file
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
+    (void)storage;
+    char host_old[512];
+    char host_new[512];
+    if(!storage_host_path(old_path, host_old, sizeof(host_old)) ||
+       !storage_host_path(new_path, host_new, sizeof(host_new))) {
+        return FSE_INVALID_NAME;
+    }
+    if(access(host_new, F_OK) == 0) return FSE_EXIST;
+    return rename(host_old, host_new) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}